@@ -46,216 +46,105 @@ std::string to_string(T var) {
 }
 #endif
 
-void SetLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, ImageSubresourcePair imgpair, const VkImageLayout &layout) {
-    if (pCB->imageLayoutMap.find(imgpair) != pCB->imageLayoutMap.end()) {
-        pCB->imageLayoutMap[imgpair].layout = layout;
-    } else {
-        assert(imgpair.hasSubresource);
-        IMAGE_CMD_BUF_LAYOUT_NODE node;
-        if (!FindCmdBufLayout(device_data, pCB, imgpair.image, imgpair.subresource, node)) {
-            node.initialLayout = layout;
+// Call func(aspect_index, begin, end) with the subresource key range of each aspect and mip level covered by range.
+// The level and layer counts of range must already be resolved.
+template <typename Fn>
+static void ForEachSubresourceKeyRange(const VkImageSubresourceRange &range, Fn &&func) {
+    for (uint32_t aspect_index = 0; aspect_index < kImageLayoutAspectCount; ++aspect_index) {
+        if (!(range.aspectMask & kImageLayoutAspects[aspect_index])) continue;
+        for (uint32_t level = range.baseMipLevel; level < range.baseMipLevel + range.levelCount; ++level) {
+            func(aspect_index, ImageSubresourceKey(aspect_index, level, range.baseArrayLayer),
+                 ImageSubresourceKey(aspect_index, level, range.baseArrayLayer + range.layerCount));
         }
-        SetLayout(device_data, pCB, imgpair, {node.initialLayout, layout});
-    }
-}
-template <class OBJECT, class LAYOUT>
-void SetLayout(layer_data *device_data, OBJECT *pObject, VkImage image, VkImageSubresource range, const LAYOUT &layout) {
-    ImageSubresourcePair imgpair = {image, true, range};
-    SetLayout(device_data, pObject, imgpair, layout, VK_IMAGE_ASPECT_COLOR_BIT);
-    SetLayout(device_data, pObject, imgpair, layout, VK_IMAGE_ASPECT_DEPTH_BIT);
-    SetLayout(device_data, pObject, imgpair, layout, VK_IMAGE_ASPECT_STENCIL_BIT);
-    SetLayout(device_data, pObject, imgpair, layout, VK_IMAGE_ASPECT_METADATA_BIT);
-}
-
-template <class OBJECT, class LAYOUT>
-void SetLayout(layer_data *device_data, OBJECT *pObject, ImageSubresourcePair imgpair, const LAYOUT &layout,
-               VkImageAspectFlags aspectMask) {
-    if (imgpair.subresource.aspectMask & aspectMask) {
-        imgpair.subresource.aspectMask = aspectMask;
-        SetLayout(device_data, pObject, imgpair, layout);
     }
 }
 
-// Set the layout in supplied map
-void SetLayout(std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> &imageLayoutMap, ImageSubresourcePair imgpair,
-               VkImageLayout layout) {
-    imageLayoutMap[imgpair].layout = layout;
+// Set the layout on the cmdbuf level. Subresources without a layout in this cmdbuf also take it as their initial layout.
+static void SetLayout(GLOBAL_CB_NODE *pCB, VkImage image, const VkImageSubresourceRange &range, const VkImageLayout &layout) {
+    pCB->image_layout_change_count++;
+    auto &cb_layouts = pCB->imageLayoutMap[image];
+    ForEachSubresourceKeyRange(range, [&](uint32_t, uint64_t begin, uint64_t end) {
+        cb_layouts.Update(begin, end, [&layout](IMAGE_CMD_BUF_LAYOUT_NODE &node) { node.layout = layout; },
+                          IMAGE_CMD_BUF_LAYOUT_NODE(layout, layout));
+    });
 }
 
-bool FindLayoutVerifyNode(layer_data const *device_data, GLOBAL_CB_NODE const *pCB, ImageSubresourcePair imgpair,
-                          IMAGE_CMD_BUF_LAYOUT_NODE &node, const VkImageAspectFlags aspectMask) {
+bool FindLayoutVerifyNode(layer_data const *device_data, VkImage image,
+                          const SubresourceRangeMap<IMAGE_CMD_BUF_LAYOUT_NODE> &cb_layouts, VkImageSubresource subresource,
+                          IMAGE_CMD_BUF_LAYOUT_NODE &node, uint32_t aspect_index) {
     const debug_report_data *report_data = core_validation::GetReportData(device_data);
 
-    if (!(imgpair.subresource.aspectMask & aspectMask)) {
+    if (!(subresource.aspectMask & kImageLayoutAspects[aspect_index])) {
         return false;
     }
-    VkImageAspectFlags oldAspectMask = imgpair.subresource.aspectMask;
-    imgpair.subresource.aspectMask = aspectMask;
-    auto imgsubIt = pCB->imageLayoutMap.find(imgpair);
-    if (imgsubIt == pCB->imageLayoutMap.end()) {
+    auto found = cb_layouts.Find(ImageSubresourceKey(aspect_index, subresource.mipLevel, subresource.arrayLayer));
+    if (!found) {
         return false;
     }
-    if (node.layout != VK_IMAGE_LAYOUT_MAX_ENUM && node.layout != imgsubIt->second.layout) {
-        log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, HandleToUint64(imgpair.image),
-                __LINE__, DRAWSTATE_INVALID_LAYOUT, "DS",
+    if (node.layout != VK_IMAGE_LAYOUT_MAX_ENUM && node.layout != found->layout) {
+        log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, HandleToUint64(image), __LINE__,
+                DRAWSTATE_INVALID_LAYOUT, "DS",
                 "Cannot query for VkImage 0x%" PRIx64 " layout when combined aspect mask %d has multiple layout types: %s and %s",
-                HandleToUint64(imgpair.image), oldAspectMask, string_VkImageLayout(node.layout),
-                string_VkImageLayout(imgsubIt->second.layout));
+                HandleToUint64(image), subresource.aspectMask, string_VkImageLayout(node.layout),
+                string_VkImageLayout(found->layout));
     }
-    if (node.initialLayout != VK_IMAGE_LAYOUT_MAX_ENUM && node.initialLayout != imgsubIt->second.initialLayout) {
-        log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, HandleToUint64(imgpair.image),
-                __LINE__, DRAWSTATE_INVALID_LAYOUT, "DS",
+    if (node.initialLayout != VK_IMAGE_LAYOUT_MAX_ENUM && node.initialLayout != found->initialLayout) {
+        log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, HandleToUint64(image), __LINE__,
+                DRAWSTATE_INVALID_LAYOUT, "DS",
                 "Cannot query for VkImage 0x%" PRIx64
                 " layout when combined aspect mask %d has multiple initial layout types: %s and %s",
-                HandleToUint64(imgpair.image), oldAspectMask, string_VkImageLayout(node.initialLayout),
-                string_VkImageLayout(imgsubIt->second.initialLayout));
+                HandleToUint64(image), subresource.aspectMask, string_VkImageLayout(node.initialLayout),
+                string_VkImageLayout(found->initialLayout));
     }
-    node = imgsubIt->second;
-    return true;
-}
-
-bool FindLayoutVerifyLayout(layer_data const *device_data, ImageSubresourcePair imgpair, VkImageLayout &layout,
-                            const VkImageAspectFlags aspectMask) {
-    if (!(imgpair.subresource.aspectMask & aspectMask)) {
-        return false;
-    }
-    const debug_report_data *report_data = core_validation::GetReportData(device_data);
-    VkImageAspectFlags oldAspectMask = imgpair.subresource.aspectMask;
-    imgpair.subresource.aspectMask = aspectMask;
-    auto imgsubIt = (*core_validation::GetImageLayoutMap(device_data)).find(imgpair);
-    if (imgsubIt == (*core_validation::GetImageLayoutMap(device_data)).end()) {
-        return false;
-    }
-    if (layout != VK_IMAGE_LAYOUT_MAX_ENUM && layout != imgsubIt->second.layout) {
-        log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT, HandleToUint64(imgpair.image),
-                __LINE__, DRAWSTATE_INVALID_LAYOUT, "DS",
-                "Cannot query for VkImage 0x%" PRIx64 " layout when combined aspect mask %d has multiple layout types: %s and %s",
-                HandleToUint64(imgpair.image), oldAspectMask, string_VkImageLayout(layout),
-                string_VkImageLayout(imgsubIt->second.layout));
-    }
-    layout = imgsubIt->second.layout;
+    node = *found;
     return true;
 }
 
 // Find layout(s) on the command buffer level
 bool FindCmdBufLayout(layer_data const *device_data, GLOBAL_CB_NODE const *pCB, VkImage image, VkImageSubresource range,
                       IMAGE_CMD_BUF_LAYOUT_NODE &node) {
-    ImageSubresourcePair imgpair = {image, true, range};
     node = IMAGE_CMD_BUF_LAYOUT_NODE(VK_IMAGE_LAYOUT_MAX_ENUM, VK_IMAGE_LAYOUT_MAX_ENUM);
-    FindLayoutVerifyNode(device_data, pCB, imgpair, node, VK_IMAGE_ASPECT_COLOR_BIT);
-    FindLayoutVerifyNode(device_data, pCB, imgpair, node, VK_IMAGE_ASPECT_DEPTH_BIT);
-    FindLayoutVerifyNode(device_data, pCB, imgpair, node, VK_IMAGE_ASPECT_STENCIL_BIT);
-    FindLayoutVerifyNode(device_data, pCB, imgpair, node, VK_IMAGE_ASPECT_METADATA_BIT);
-    if (node.layout == VK_IMAGE_LAYOUT_MAX_ENUM) {
-        imgpair = {image, false, VkImageSubresource()};
-        auto imgsubIt = pCB->imageLayoutMap.find(imgpair);
-        if (imgsubIt == pCB->imageLayoutMap.end()) return false;
-        // TODO: This is ostensibly a find function but it changes state here
-        node = imgsubIt->second;
+    auto cb_layouts = pCB->imageLayoutMap.find(image);
+    if (cb_layouts == pCB->imageLayoutMap.end()) return false;
+    bool found = false;
+    for (uint32_t aspect_index = 0; aspect_index < kImageLayoutAspectCount; ++aspect_index) {
+        found |= FindLayoutVerifyNode(device_data, image, cb_layouts->second, range, node, aspect_index);
     }
-    return true;
-}
-
-// Find layout(s) on the global level
-bool FindGlobalLayout(layer_data *device_data, ImageSubresourcePair imgpair, VkImageLayout &layout) {
-    layout = VK_IMAGE_LAYOUT_MAX_ENUM;
-    FindLayoutVerifyLayout(device_data, imgpair, layout, VK_IMAGE_ASPECT_COLOR_BIT);
-    FindLayoutVerifyLayout(device_data, imgpair, layout, VK_IMAGE_ASPECT_DEPTH_BIT);
-    FindLayoutVerifyLayout(device_data, imgpair, layout, VK_IMAGE_ASPECT_STENCIL_BIT);
-    FindLayoutVerifyLayout(device_data, imgpair, layout, VK_IMAGE_ASPECT_METADATA_BIT);
-    if (layout == VK_IMAGE_LAYOUT_MAX_ENUM) {
-        imgpair = {imgpair.image, false, VkImageSubresource()};
-        auto imgsubIt = (*core_validation::GetImageLayoutMap(device_data)).find(imgpair);
-        if (imgsubIt == (*core_validation::GetImageLayoutMap(device_data)).end()) return false;
-        layout = imgsubIt->second.layout;
-    }
-    return true;
+    return found;
 }
 
 bool FindLayouts(layer_data *device_data, VkImage image, std::vector<VkImageLayout> &layouts) {
-    auto sub_data = (*core_validation::GetImageSubresourceMap(device_data)).find(image);
-    if (sub_data == (*core_validation::GetImageSubresourceMap(device_data)).end()) return false;
+    auto image_layouts = core_validation::GetImageLayoutMap(device_data)->find(image);
+    if (image_layouts == core_validation::GetImageLayoutMap(device_data)->end()) return false;
     auto image_state = GetImageState(device_data, image);
     if (!image_state) return false;
-    bool ignoreGlobal = false;
-    // TODO: Make this robust for >1 aspect mask. Now it will just say ignore potential errors in this case.
-    if (sub_data->second.size() >= (image_state->createInfo.arrayLayers * image_state->createInfo.mipLevels + 1)) {
-        ignoreGlobal = true;
-    }
-    for (auto imgsubpair : sub_data->second) {
-        if (ignoreGlobal && !imgsubpair.hasSubresource) continue;
-        auto img_data = (*core_validation::GetImageLayoutMap(device_data)).find(imgsubpair);
-        if (img_data != (*core_validation::GetImageLayoutMap(device_data)).end()) {
-            layouts.push_back(img_data->second.layout);
-        }
-    }
-    return true;
-}
-bool FindLayout(const std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> &imageLayoutMap, ImageSubresourcePair imgpair,
-                VkImageLayout &layout, const VkImageAspectFlags aspectMask) {
-    if (!(imgpair.subresource.aspectMask & aspectMask)) {
-        return false;
+    uint64_t tracked_subresources = 0;
+    for (const auto &run : image_layouts->second.subresource_layouts) {
+        tracked_subresources += run.second.end - run.first;
+        layouts.push_back(run.second.value);
     }
-    imgpair.subresource.aspectMask = aspectMask;
-    auto imgsubIt = imageLayoutMap.find(imgpair);
-    if (imgsubIt == imageLayoutMap.end()) {
-        return false;
-    }
-    layout = imgsubIt->second.layout;
-    return true;
-}
-
-// find layout in supplied map
-bool FindLayout(const std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> &imageLayoutMap, ImageSubresourcePair imgpair,
-                VkImageLayout &layout) {
-    layout = VK_IMAGE_LAYOUT_MAX_ENUM;
-    FindLayout(imageLayoutMap, imgpair, layout, VK_IMAGE_ASPECT_COLOR_BIT);
-    FindLayout(imageLayoutMap, imgpair, layout, VK_IMAGE_ASPECT_DEPTH_BIT);
-    FindLayout(imageLayoutMap, imgpair, layout, VK_IMAGE_ASPECT_STENCIL_BIT);
-    FindLayout(imageLayoutMap, imgpair, layout, VK_IMAGE_ASPECT_METADATA_BIT);
-    if (layout == VK_IMAGE_LAYOUT_MAX_ENUM) {
-        imgpair = {imgpair.image, false, VkImageSubresource()};
-        auto imgsubIt = imageLayoutMap.find(imgpair);
-        if (imgsubIt == imageLayoutMap.end()) return false;
-        layout = imgsubIt->second.layout;
+    // The image-wide layout only applies if some subresource has no layout of its own
+    // TODO: Make this robust for >1 aspect mask. Now it will just say ignore potential errors in this case.
+    if (tracked_subresources < static_cast<uint64_t>(image_state->createInfo.arrayLayers) * image_state->createInfo.mipLevels) {
+        layouts.push_back(image_layouts->second.layout);
     }
     return true;
 }
 
-// Set the layout on the global level
-void SetGlobalLayout(layer_data *device_data, ImageSubresourcePair imgpair, const VkImageLayout &layout) {
-    VkImage &image = imgpair.image;
-    (*core_validation::GetImageLayoutMap(device_data))[imgpair].layout = layout;
-    auto &image_subresources = (*core_validation::GetImageSubresourceMap(device_data))[image];
-    auto subresource = std::find(image_subresources.begin(), image_subresources.end(), imgpair);
-    if (subresource == image_subresources.end()) {
-        image_subresources.push_back(imgpair);
-    }
-}
-
-// Set the layout on the cmdbuf level
-void SetLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, ImageSubresourcePair imgpair, const IMAGE_CMD_BUF_LAYOUT_NODE &node) {
-    pCB->imageLayoutMap[imgpair] = node;
-}
 // Set image layout for given VkImageSubresourceRange struct
 void SetImageLayout(layer_data *device_data, GLOBAL_CB_NODE *cb_node, const IMAGE_STATE *image_state,
                     VkImageSubresourceRange image_subresource_range, const VkImageLayout &layout) {
     assert(image_state);
-    for (uint32_t level_index = 0; level_index < image_subresource_range.levelCount; ++level_index) {
-        uint32_t level = image_subresource_range.baseMipLevel + level_index;
-        for (uint32_t layer_index = 0; layer_index < image_subresource_range.layerCount; layer_index++) {
-            uint32_t layer = image_subresource_range.baseArrayLayer + layer_index;
-            VkImageSubresource sub = {image_subresource_range.aspectMask, level, layer};
-            // TODO: If ImageView was created with depth or stencil, transition both layouts as the aspectMask is ignored and both
-            // are used. Verify that the extra implicit layout is OK for descriptor set layout validation
-            if (image_subresource_range.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
-                if (FormatIsDepthAndStencil(image_state->createInfo.format)) {
-                    sub.aspectMask |= (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
-                }
-            }
-            SetLayout(device_data, cb_node, image_state->image, sub, layout);
+    image_subresource_range.levelCount = ResolveRemainingLevels(&image_subresource_range, image_state->createInfo.mipLevels);
+    image_subresource_range.layerCount = ResolveRemainingLayers(&image_subresource_range, image_state->createInfo.arrayLayers);
+    // TODO: If ImageView was created with depth or stencil, transition both layouts as the aspectMask is ignored and both
+    // are used. Verify that the extra implicit layout is OK for descriptor set layout validation
+    if (image_subresource_range.aspectMask & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)) {
+        if (FormatIsDepthAndStencil(image_state->createInfo.format)) {
+            image_subresource_range.aspectMask |= (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT);
         }
     }
+    SetLayout(cb_node, image_state->image, image_subresource_range, layout);
 }
 // Set image layout for given VkImageSubresourceLayers struct
 void SetImageLayout(layer_data *device_data, GLOBAL_CB_NODE *cb_node, const IMAGE_STATE *image_state,
@@ -351,28 +240,30 @@ void TransitionSubpassLayouts(layer_data *device_data, GLOBAL_CB_NODE *pCB, cons
     }
 }
 
-bool ValidateImageAspectLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
-                               uint32_t level, uint32_t layer, VkImageAspectFlags aspect) {
-    if (!(mem_barrier->subresourceRange.aspectMask & aspect)) {
-        return false;
-    }
-    VkImageSubresource sub = {aspect, level, layer};
-    IMAGE_CMD_BUF_LAYOUT_NODE node;
-    if (!FindCmdBufLayout(device_data, pCB, mem_barrier->image, sub, node)) {
-        return false;
-    }
+bool ValidateImageRangeLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
+                              const VkImageSubresourceRange &range) {
     bool skip = false;
     if (mem_barrier->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
         // TODO: Set memory invalid which is in mem_tracker currently
-    } else if (node.layout != mem_barrier->oldLayout) {
-        skip |=
-            log_msg(core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT,
-                    VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, HandleToUint64(pCB->commandBuffer), __LINE__,
-                    DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
-                    "For image 0x%" PRIxLEAST64 " you cannot transition the layout of aspect %d from %s when current layout is %s.",
-                    HandleToUint64(mem_barrier->image), aspect, string_VkImageLayout(mem_barrier->oldLayout),
-                    string_VkImageLayout(node.layout));
+        return skip;
     }
+    auto cb_layouts = pCB->imageLayoutMap.find(mem_barrier->image);
+    if (cb_layouts == pCB->imageLayoutMap.end()) {
+        return skip;
+    }
+    ForEachSubresourceKeyRange(range, [&](uint32_t aspect_index, uint64_t begin, uint64_t end) {
+        cb_layouts->second.ForEachInRange(begin, end, [&](uint64_t, uint64_t, const IMAGE_CMD_BUF_LAYOUT_NODE *node) {
+            if (node && node->layout != mem_barrier->oldLayout) {
+                skip |= log_msg(core_validation::GetReportData(device_data), VK_DEBUG_REPORT_ERROR_BIT_EXT,
+                                VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT, HandleToUint64(pCB->commandBuffer), __LINE__,
+                                DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
+                                "For image 0x%" PRIxLEAST64
+                                " you cannot transition the layout of aspect %d from %s when current layout is %s.",
+                                HandleToUint64(mem_barrier->image), kImageLayoutAspects[aspect_index],
+                                string_VkImageLayout(mem_barrier->oldLayout), string_VkImageLayout(node->layout));
+            }
+        });
+    });
     return skip;
 }
 
@@ -391,22 +282,16 @@ void TransitionBeginRenderPassLayouts(layer_data *device_data, GLOBAL_CB_NODE *c
     TransitionSubpassLayouts(device_data, cb_state, render_pass_state, 0, framebuffer_state);
 }
 
-void TransitionImageAspectLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
-                                 uint32_t level, uint32_t layer, VkImageAspectFlags aspect) {
-    if (!(mem_barrier->subresourceRange.aspectMask & aspect)) {
-        return;
-    }
-    VkImageSubresource sub = {aspect, level, layer};
-    IMAGE_CMD_BUF_LAYOUT_NODE node;
-    if (!FindCmdBufLayout(device_data, pCB, mem_barrier->image, sub, node)) {
-        SetLayout(device_data, pCB, mem_barrier->image, sub,
-                  IMAGE_CMD_BUF_LAYOUT_NODE(mem_barrier->oldLayout, mem_barrier->newLayout));
-        return;
-    }
-    if (mem_barrier->oldLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
-        // TODO: Set memory invalid
-    }
-    SetLayout(device_data, pCB, mem_barrier->image, sub, mem_barrier->newLayout);
+void TransitionImageRangeLayout(layer_data *device_data, GLOBAL_CB_NODE *pCB, const VkImageMemoryBarrier *mem_barrier,
+                                const VkImageSubresourceRange &range) {
+    pCB->image_layout_change_count++;
+    auto &cb_layouts = pCB->imageLayoutMap[mem_barrier->image];
+    const VkImageLayout new_layout = mem_barrier->newLayout;
+    // Subresources first used by this barrier start out in its oldLayout
+    ForEachSubresourceKeyRange(range, [&](uint32_t, uint64_t begin, uint64_t end) {
+        cb_layouts.Update(begin, end, [new_layout](IMAGE_CMD_BUF_LAYOUT_NODE &node) { node.layout = new_layout; },
+                          IMAGE_CMD_BUF_LAYOUT_NODE(mem_barrier->oldLayout, new_layout));
+    });
 }
 
 bool VerifyAspectsPresent(VkImageAspectFlags aspect_mask, VkFormat format) {
@@ -522,19 +407,10 @@ bool ValidateBarriersToImages(layer_data *device_data, VkCommandBuffer cmdBuffer
                             aspect_mask, validation_error_map[VALIDATION_ERROR_0a00096e]);
             }
         }
-        uint32_t level_count = ResolveRemainingLevels(&img_barrier->subresourceRange, image_create_info->mipLevels);
-        uint32_t layer_count = ResolveRemainingLayers(&img_barrier->subresourceRange, image_create_info->arrayLayers);
-
-        for (uint32_t j = 0; j < level_count; j++) {
-            uint32_t level = img_barrier->subresourceRange.baseMipLevel + j;
-            for (uint32_t k = 0; k < layer_count; k++) {
-                uint32_t layer = img_barrier->subresourceRange.baseArrayLayer + k;
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_COLOR_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_DEPTH_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_STENCIL_BIT);
-                skip |= ValidateImageAspectLayout(device_data, pCB, img_barrier, level, layer, VK_IMAGE_ASPECT_METADATA_BIT);
-            }
-        }
+        VkImageSubresourceRange range = img_barrier->subresourceRange;
+        range.levelCount = ResolveRemainingLevels(&img_barrier->subresourceRange, image_create_info->mipLevels);
+        range.layerCount = ResolveRemainingLayers(&img_barrier->subresourceRange, image_create_info->arrayLayers);
+        skip |= ValidateImageRangeLayout(device_data, pCB, img_barrier, range);
     }
     return skip;
 }
@@ -548,19 +424,10 @@ void TransitionImageLayouts(layer_data *device_data, VkCommandBuffer cmdBuffer,
         if (!mem_barrier) continue;
 
         VkImageCreateInfo *image_create_info = &(GetImageState(device_data, mem_barrier->image)->createInfo);
-        uint32_t level_count = ResolveRemainingLevels(&mem_barrier->subresourceRange, image_create_info->mipLevels);
-        uint32_t layer_count = ResolveRemainingLayers(&mem_barrier->subresourceRange, image_create_info->arrayLayers);
-
-        for (uint32_t j = 0; j < level_count; j++) {
-            uint32_t level = mem_barrier->subresourceRange.baseMipLevel + j;
-            for (uint32_t k = 0; k < layer_count; k++) {
-                uint32_t layer = mem_barrier->subresourceRange.baseArrayLayer + k;
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_COLOR_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_DEPTH_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_STENCIL_BIT);
-                TransitionImageAspectLayout(device_data, pCB, mem_barrier, level, layer, VK_IMAGE_ASPECT_METADATA_BIT);
-            }
-        }
+        VkImageSubresourceRange range = mem_barrier->subresourceRange;
+        range.levelCount = ResolveRemainingLevels(&mem_barrier->subresourceRange, image_create_info->mipLevels);
+        range.layerCount = ResolveRemainingLayers(&mem_barrier->subresourceRange, image_create_info->arrayLayers);
+        TransitionImageRangeLayout(device_data, pCB, mem_barrier, range);
     }
 }
 
@@ -811,9 +678,7 @@ void PostCallRecordCreateImage(layer_data *device_data, const VkImageCreateInfo
     image_state.layout = pCreateInfo->initialLayout;
     image_state.format = pCreateInfo->format;
     GetImageMap(device_data)->insert(std::make_pair(*pImage, std::unique_ptr<IMAGE_STATE>(new IMAGE_STATE(*pImage, pCreateInfo))));
-    ImageSubresourcePair subpair{*pImage, false, VkImageSubresource()};
-    (*core_validation::GetImageSubresourceMap(device_data))[*pImage].push_back(subpair);
-    (*core_validation::GetImageLayoutMap(device_data))[subpair] = image_state;
+    (*core_validation::GetImageLayoutMap(device_data))[*pImage] = image_state;
 }
 
 bool PreCallValidateDestroyImage(layer_data *device_data, VkImage image, IMAGE_STATE **image_state, VK_OBJECT *obj_struct) {
@@ -840,16 +705,7 @@ void PostCallRecordDestroyImage(layer_data *device_data, VkImage image, IMAGE_ST
     core_validation::ClearMemoryObjectBindings(device_data, obj_struct.handle, kVulkanObjectTypeImage);
     // Remove image from imageMap
     core_validation::GetImageMap(device_data)->erase(image);
-    std::unordered_map<VkImage, std::vector<ImageSubresourcePair>> *imageSubresourceMap =
-        core_validation::GetImageSubresourceMap(device_data);
-
-    const auto &sub_entry = imageSubresourceMap->find(image);
-    if (sub_entry != imageSubresourceMap->end()) {
-        for (const auto &pair : sub_entry->second) {
-            core_validation::GetImageLayoutMap(device_data)->erase(pair);
-        }
-        imageSubresourceMap->erase(sub_entry);
-    }
+    core_validation::GetImageLayoutMap(device_data)->erase(image);
 }
 
 bool ValidateImageAttributes(layer_data *device_data, IMAGE_STATE *image_state, VkImageSubresourceRange range) {
@@ -980,20 +836,16 @@ bool VerifyClearImageLayout(layer_data *device_data, GLOBAL_CB_NODE *cb_node, IM
 void RecordClearImageLayout(layer_data *device_data, GLOBAL_CB_NODE *cb_node, VkImage image, VkImageSubresourceRange range,
                             VkImageLayout dest_image_layout) {
     VkImageCreateInfo *image_create_info = &(GetImageState(device_data, image)->createInfo);
-    uint32_t level_count = ResolveRemainingLevels(&range, image_create_info->mipLevels);
-    uint32_t layer_count = ResolveRemainingLayers(&range, image_create_info->arrayLayers);
+    range.levelCount = ResolveRemainingLevels(&range, image_create_info->mipLevels);
+    range.layerCount = ResolveRemainingLayers(&range, image_create_info->arrayLayers);
 
-    for (uint32_t level_index = 0; level_index < level_count; ++level_index) {
-        uint32_t level = level_index + range.baseMipLevel;
-        for (uint32_t layer_index = 0; layer_index < layer_count; ++layer_index) {
-            uint32_t layer = layer_index + range.baseArrayLayer;
-            VkImageSubresource sub = {range.aspectMask, level, layer};
-            IMAGE_CMD_BUF_LAYOUT_NODE node;
-            if (!FindCmdBufLayout(device_data, cb_node, image, sub, node)) {
-                SetLayout(device_data, cb_node, image, sub, IMAGE_CMD_BUF_LAYOUT_NODE(dest_image_layout, dest_image_layout));
-            }
-        }
-    }
+    // Only subresources with no layout in this command buffer yet are recorded
+    cb_node->image_layout_change_count++;
+    auto &cb_layouts = cb_node->imageLayoutMap[image];
+    ForEachSubresourceKeyRange(range, [&](uint32_t, uint64_t begin, uint64_t end) {
+        cb_layouts.Update(begin, end, [](IMAGE_CMD_BUF_LAYOUT_NODE &) {},
+                          IMAGE_CMD_BUF_LAYOUT_NODE(dest_image_layout, dest_image_layout));
+    });
 }
 
 bool PreCallValidateCmdClearColorImage(layer_data *dev_data, VkCommandBuffer commandBuffer, VkImage image,
@@ -2464,48 +2316,65 @@ void PreCallRecordCmdBlitImage(layer_data *device_data, GLOBAL_CB_NODE *cb_node,
 
 // This validates that the initial layout specified in the command buffer for
 // the IMAGE is the same
-// as the global IMAGE layout
+// as the global IMAGE layout. Layouts transitioned by earlier command buffers of the same
+// submission are recorded in overlayLayoutMap rather than in a copy of the global map.
 bool ValidateCmdBufImageLayouts(layer_data *device_data, GLOBAL_CB_NODE *pCB,
-                                std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> &imageLayoutMap) {
+                                const std::unordered_map<VkImage, IMAGE_LAYOUT_NODE> &globalImageLayoutMap,
+                                std::unordered_map<VkImage, SubresourceRangeMap<VkImageLayout>> &overlayLayoutMap) {
     bool skip = false;
     const debug_report_data *report_data = core_validation::GetReportData(device_data);
-    for (auto cb_image_data : pCB->imageLayoutMap) {
-        VkImageLayout imageLayout;
-
-        if (FindLayout(imageLayoutMap, cb_image_data.first, imageLayout)) {
-            if (cb_image_data.second.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
+    for (const auto &cb_image_data : pCB->imageLayoutMap) {
+        const VkImage image = cb_image_data.first;
+        auto global_image_data = globalImageLayoutMap.find(image);
+        if (global_image_data == globalImageLayoutMap.end()) continue;
+        const IMAGE_LAYOUT_NODE &global_layouts = global_image_data->second;
+        auto &overlay_layouts = overlayLayoutMap[image];
+
+        for (const auto &cb_run : cb_image_data.second) {
+            const IMAGE_CMD_BUF_LAYOUT_NODE &node = cb_run.second.value;
+            if (node.initialLayout == VK_IMAGE_LAYOUT_UNDEFINED) {
                 // TODO: Set memory invalid which is in mem_tracker currently
-            } else if (imageLayout != cb_image_data.second.initialLayout) {
-                if (cb_image_data.first.hasSubresource) {
+            } else {
+                auto check_layout = [&](uint64_t begin, uint64_t end, VkImageLayout imageLayout) {
+                    if (imageLayout == node.initialLayout) return;
+                    const VkImageSubresource sub = ImageSubresourceFromKey(begin);
                     skip |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
                                     HandleToUint64(pCB->commandBuffer), __LINE__, DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
                                     "Cannot submit cmd buffer using image (0x%" PRIx64
-                                    ") [sub-resource: aspectMask 0x%X array layer %u, mip level %u], "
+                                    ") [sub-resource: aspectMask 0x%X array layers %u-%u, mip level %u], "
                                     "with layout %s when first use is %s.",
-                                    HandleToUint64(cb_image_data.first.image), cb_image_data.first.subresource.aspectMask,
-                                    cb_image_data.first.subresource.arrayLayer, cb_image_data.first.subresource.mipLevel,
-                                    string_VkImageLayout(imageLayout), string_VkImageLayout(cb_image_data.second.initialLayout));
-                } else {
-                    skip |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
-                                    HandleToUint64(pCB->commandBuffer), __LINE__, DRAWSTATE_INVALID_IMAGE_LAYOUT, "DS",
-                                    "Cannot submit cmd buffer using image (0x%" PRIx64
-                                    ") with layout %s when "
-                                    "first use is %s.",
-                                    HandleToUint64(cb_image_data.first.image), string_VkImageLayout(imageLayout),
-                                    string_VkImageLayout(cb_image_data.second.initialLayout));
-                }
+                                    HandleToUint64(image), sub.aspectMask, sub.arrayLayer,
+                                    sub.arrayLayer + static_cast<uint32_t>(end - begin) - 1, sub.mipLevel,
+                                    string_VkImageLayout(imageLayout), string_VkImageLayout(node.initialLayout));
+                };
+                // Current layout comes from this submission's overlay, then the recorded per-subresource layouts, then
+                // the layout the image was created in
+                overlay_layouts.ForEachInRange(
+                    cb_run.first, cb_run.second.end, [&](uint64_t begin, uint64_t end, const VkImageLayout *overlay_layout) {
+                        if (overlay_layout) {
+                            check_layout(begin, end, *overlay_layout);
+                            return;
+                        }
+                        global_layouts.subresource_layouts.ForEachInRange(
+                            begin, end, [&](uint64_t sub_begin, uint64_t sub_end, const VkImageLayout *global_layout) {
+                                check_layout(sub_begin, sub_end, global_layout ? *global_layout : global_layouts.layout);
+                            });
+                    });
             }
-            SetLayout(imageLayoutMap, cb_image_data.first, cb_image_data.second.layout);
+            overlay_layouts.Set(cb_run.first, cb_run.second.end, node.layout);
         }
     }
     return skip;
 }
 
 void UpdateCmdBufImageLayouts(layer_data *device_data, GLOBAL_CB_NODE *pCB) {
-    for (auto cb_image_data : pCB->imageLayoutMap) {
-        VkImageLayout imageLayout;
-        FindGlobalLayout(device_data, cb_image_data.first, imageLayout);
-        SetGlobalLayout(device_data, cb_image_data.first, cb_image_data.second.layout);
+    auto image_layout_map = core_validation::GetImageLayoutMap(device_data);
+    for (const auto &cb_image_data : pCB->imageLayoutMap) {
+        auto global_image_data = image_layout_map->find(cb_image_data.first);
+        if (global_image_data == image_layout_map->end()) continue;
+        for (const auto &cb_run : cb_image_data.second) {
+            global_image_data->second.subresource_layouts.Set(cb_run.first, cb_run.second.end, cb_run.second.value.layout);
+        }
     }
 }
 
@@ -52,6 +52,7 @@
 #include "vk_layer_logging.h"
 #include "vk_object_types.h"
 #include "vk_extension_helper.h"
+#include "image_layout_map.h"
 #include <atomic>
 #include <functional>
 #include <map>
@@ -60,7 +61,9 @@
 #include <unordered_set>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <list>
+#include <set>
 
 // Fwd declarations
 namespace cvdescriptorset {
@@ -85,8 +88,15 @@ class BASE_NODE {
     //  binding removed when command buffer is reset or destroyed
     // When an object is destroyed, any bound cbs are set to INVALID
     std::unordered_set<GLOBAL_CB_NODE *> cb_bindings;
+    // Command buffers recorded on different threads may bind the same object concurrently
+    std::mutex cb_bindings_lock;
 
     BASE_NODE() { in_use.store(0); };
+
+    void AddCommandBufferBinding(GLOBAL_CB_NODE *cb_node) {
+        std::lock_guard<std::mutex> lock(cb_bindings_lock);
+        cb_bindings.insert(cb_node);
+    }
 };
 
 // Track command pools and their command buffers
@@ -309,8 +319,127 @@ struct MEMORY_RANGE {
     VkDeviceSize start;
     VkDeviceSize size;
     VkDeviceSize end;  // Store this pre-computed for simplicity
-    // Set of ptrs to every range aliased with this one
-    std::unordered_set<MEMORY_RANGE *> aliases;
+};
+
+// The ranges bound to a memory object, kept in a treap ordered by start offset in which every node also records the
+// largest end offset in its subtree. An overlap query skips any subtree that ends before the queried interval and stops
+// at nodes starting after it, so it costs O(log n + k) for k overlapping ranges however long the bound ranges are.
+class MemoryRangeIndex {
+   public:
+    MemoryRangeIndex() : root_(nullptr), seed_(0x9E3779B9u) {}
+    ~MemoryRangeIndex() { Destroy(root_); }
+    MemoryRangeIndex(const MemoryRangeIndex &) = delete;
+    MemoryRangeIndex &operator=(const MemoryRangeIndex &) = delete;
+
+    void Insert(MEMORY_RANGE *range) {
+        // xorshift32, only used to keep the treap balanced
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 17;
+        seed_ ^= seed_ << 5;
+        Node *node = new Node{range, seed_, range->end, nullptr, nullptr};
+        root_ = Insert(root_, node);
+    }
+    void Erase(MEMORY_RANGE *range) { root_ = Erase(root_, range); }
+    // Call func(MEMORY_RANGE *) for each bound range that intersects [start, end]
+    template <typename Fn>
+    void ForEachCandidate(VkDeviceSize start, VkDeviceSize end, Fn &&func) const {
+        Visit(root_, start, end, func);
+    }
+
+   private:
+    struct Node {
+        MEMORY_RANGE *range;
+        uint32_t priority;
+        VkDeviceSize max_end;  // Largest range->end in this subtree
+        Node *left;
+        Node *right;
+    };
+
+    // Ranges sharing a start offset are told apart by address, so Erase finds exactly the range it was given
+    static bool Less(const MEMORY_RANGE *a, const MEMORY_RANGE *b) {
+        return a->start < b->start || (a->start == b->start && std::less<const MEMORY_RANGE *>()(a, b));
+    }
+    static void Update(Node *node) {
+        node->max_end = node->range->end;
+        if (node->left && node->left->max_end > node->max_end) node->max_end = node->left->max_end;
+        if (node->right && node->right->max_end > node->max_end) node->max_end = node->right->max_end;
+    }
+    static Node *RotateRight(Node *node) {
+        Node *left = node->left;
+        node->left = left->right;
+        left->right = node;
+        Update(node);
+        Update(left);
+        return left;
+    }
+    static Node *RotateLeft(Node *node) {
+        Node *right = node->right;
+        node->right = right->left;
+        right->left = node;
+        Update(node);
+        Update(right);
+        return right;
+    }
+    static Node *Insert(Node *root, Node *node) {
+        if (!root) return node;
+        if (Less(node->range, root->range)) {
+            root->left = Insert(root->left, node);
+            if (root->left->priority > root->priority) return RotateRight(root);
+        } else {
+            root->right = Insert(root->right, node);
+            if (root->right->priority > root->priority) return RotateLeft(root);
+        }
+        Update(root);
+        return root;
+    }
+    // Join two treaps where every range in left orders before every range in right
+    static Node *Merge(Node *left, Node *right) {
+        if (!left) return right;
+        if (!right) return left;
+        if (left->priority > right->priority) {
+            left->right = Merge(left->right, right);
+            Update(left);
+            return left;
+        }
+        right->left = Merge(left, right->left);
+        Update(right);
+        return right;
+    }
+    static Node *Erase(Node *root, MEMORY_RANGE *range) {
+        if (!root) return nullptr;
+        if (root->range == range) {
+            Node *merged = Merge(root->left, root->right);
+            delete root;
+            return merged;
+        }
+        if (Less(range, root->range)) {
+            root->left = Erase(root->left, range);
+        } else {
+            root->right = Erase(root->right, range);
+        }
+        Update(root);
+        return root;
+    }
+    template <typename Fn>
+    static void Visit(Node const *node, VkDeviceSize start, VkDeviceSize end, Fn &func) {
+        while (node && node->max_end >= start) {
+            Visit(node->left, start, end, func);
+            if (node->range->start > end) return;
+            if (node->range->end >= start) func(node->range);
+            node = node->right;
+        }
+    }
+    static void Destroy(Node *node) {
+        while (node) {
+            Destroy(node->left);
+            Node *right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+
+    Node *root_;
+    uint32_t seed_;
 };
 
 // Data struct for tracking memory object
@@ -321,6 +450,7 @@ struct DEVICE_MEM_INFO : public BASE_NODE {
     VkMemoryAllocateInfo alloc_info;
     std::unordered_set<VK_OBJECT> obj_bindings;               // objects bound to this memory
     std::unordered_map<uint64_t, MEMORY_RANGE> bound_ranges;  // Map of object to its binding range
+    MemoryRangeIndex bound_range_index;                       // bound_ranges ordered by offset, for overlap queries
     // Convenience vectors image/buff handles to speed up iterating over images or buffers independently
     std::unordered_set<uint64_t> bound_images;
     std::unordered_set<uint64_t> bound_buffers;
@@ -367,6 +497,10 @@ class IMAGE_CMD_BUF_LAYOUT_NODE {
     VkImageLayout layout;
 };
 
+inline bool operator==(const IMAGE_CMD_BUF_LAYOUT_NODE &node1, const IMAGE_CMD_BUF_LAYOUT_NODE &node2) {
+    return node1.initialLayout == node2.initialLayout && node1.layout == node2.layout;
+}
+
 // Store the DAG.
 struct DAGNode {
     uint32_t pass;
@@ -464,9 +598,19 @@ enum CBStatusFlagBits {
     // clang-format on
 };
 
+// A run of consecutive descriptors of one binding written by a descriptor update template entry
+struct TEMPLATE_UPDATE_RUN {
+    uint32_t dst_index;  // Global index of the first descriptor of the run in the destination set
+    uint32_t count;
+    size_t offset;  // Offset in pData of the first descriptor's VkDescriptorImageInfo, VkDescriptorBufferInfo or VkBufferView
+    size_t stride;
+};
+
 struct TEMPLATE_STATE {
     VkDescriptorUpdateTemplateKHR desc_update_template;
     safe_VkDescriptorUpdateTemplateCreateInfoKHR create_info;
+    // The template's entries resolved against its descriptor set layout at creation, so updates write straight into the set
+    std::vector<TEMPLATE_UPDATE_RUN> update_runs;
 
     TEMPLATE_STATE(VkDescriptorUpdateTemplateKHR update_template, safe_VkDescriptorUpdateTemplateCreateInfoKHR *pCreateInfo)
         : desc_update_template(update_template), create_info(*pCreateInfo) {}
@@ -494,35 +638,6 @@ struct DRAW_DATA {
     std::vector<VkBuffer> buffers;
 };
 
-struct ImageSubresourcePair {
-    VkImage image;
-    bool hasSubresource;
-    VkImageSubresource subresource;
-};
-
-inline bool operator==(const ImageSubresourcePair &img1, const ImageSubresourcePair &img2) {
-    if (img1.image != img2.image || img1.hasSubresource != img2.hasSubresource) return false;
-    return !img1.hasSubresource ||
-           (img1.subresource.aspectMask == img2.subresource.aspectMask && img1.subresource.mipLevel == img2.subresource.mipLevel &&
-            img1.subresource.arrayLayer == img2.subresource.arrayLayer);
-}
-
-namespace std {
-template <>
-struct hash<ImageSubresourcePair> {
-    size_t operator()(ImageSubresourcePair img) const throw() {
-        size_t hashVal = hash<uint64_t>()(reinterpret_cast<uint64_t &>(img.image));
-        hashVal ^= hash<bool>()(img.hasSubresource);
-        if (img.hasSubresource) {
-            hashVal ^= hash<uint32_t>()(reinterpret_cast<uint32_t &>(img.subresource.aspectMask));
-            hashVal ^= hash<uint32_t>()(img.subresource.mipLevel);
-            hashVal ^= hash<uint32_t>()(img.subresource.arrayLayer);
-        }
-        return hashVal;
-    }
-};
-}
-
 // Store layouts and pushconstants for PipelineLayout
 struct PIPELINE_LAYOUT_NODE {
     VkPipelineLayout layout;
@@ -628,8 +743,38 @@ struct LAST_BOUND_STATE {
         dynamicOffsets.clear();
     }
 };
+// A descriptor set that passed draw-time validation in a command buffer: the set, the slot it is bound to, and the
+// pipeline whose active slots it was validated against
+struct DRAW_VALIDATION_CACHE_KEY {
+    const PIPELINE_STATE *pipeline;
+    const cvdescriptorset::DescriptorSet *set;
+    uint32_t set_index;
+};
+
+inline bool operator==(const DRAW_VALIDATION_CACHE_KEY &a, const DRAW_VALIDATION_CACHE_KEY &b) NOEXCEPT {
+    return a.pipeline == b.pipeline && a.set == b.set && a.set_index == b.set_index;
+}
+
+namespace std {
+template <>
+struct hash<DRAW_VALIDATION_CACHE_KEY> {
+    size_t operator()(const DRAW_VALIDATION_CACHE_KEY &key) const NOEXCEPT {
+        return hash<const void *>()(key.pipeline) ^ (hash<const void *>()(key.set) << 1) ^ hash<uint32_t>()(key.set_index);
+    }
+};
+}
+
+// State a cached draw-time validation result depends on. The result is reused only while all of it is unchanged.
+struct DRAW_VALIDATION_CACHE_ENTRY {
+    uint64_t set_change_count;
+    uint64_t image_layout_change_count;
+    std::vector<uint32_t> dynamic_offsets;
+};
+
 // Cmd Buffer Wrapper Struct - TODO : This desperately needs its own class
 struct GLOBAL_CB_NODE : public BASE_NODE {
+    // Serializes vkCmd* recording into this command buffer while global_lock is only held shared
+    std::mutex recording_lock;
     VkCommandBuffer commandBuffer;
     VkCommandBufferAllocateInfo createInfo = {};
     VkCommandBufferBeginInfo beginInfo;
@@ -657,6 +802,10 @@ struct GLOBAL_CB_NODE : public BASE_NODE {
     //  dependencies that have been broken : either destroyed objects, or updated descriptor sets
     std::unordered_set<VK_OBJECT> object_bindings;
     std::vector<VK_OBJECT> broken_bindings;
+    // object_bindings and drawData buffers resolved to state pointers at vkEndCommandBuffer, one entry per object with the
+    //  number of in_use references a submission takes on it. Only valid while no bound object has been destroyed or freed.
+    std::vector<std::pair<BASE_NODE *, uint32_t>> in_use_resources;
+    bool in_use_resources_valid = false;
 
     std::unordered_set<VkEvent> waitedEvents;
     std::vector<VkEvent> writeEventsBeforeWait;
@@ -665,7 +814,12 @@ struct GLOBAL_CB_NODE : public BASE_NODE {
     std::unordered_map<QueryObject, bool> queryToStateMap;  // 0 is unavailable, 1 is available
     std::unordered_set<QueryObject> activeQueries;
     std::unordered_set<QueryObject> startedQueries;
-    std::unordered_map<ImageSubresourcePair, IMAGE_CMD_BUF_LAYOUT_NODE> imageLayoutMap;
+    std::unordered_map<VkImage, SubresourceRangeMap<IMAGE_CMD_BUF_LAYOUT_NODE>> imageLayoutMap;
+    uint64_t image_layout_change_count = 0;  // Incremented on every change to imageLayoutMap
+    // Descriptor sets that passed draw-time validation, so identical draws can skip it
+    std::unordered_map<DRAW_VALIDATION_CACHE_KEY, DRAW_VALIDATION_CACHE_ENTRY> draw_validation_cache;
+    uint64_t draw_validation_cache_hits = 0;
+    uint64_t draw_validation_cache_misses = 0;
     std::unordered_map<VkEvent, VkPipelineStageFlags> eventToStageMap;
     std::vector<DRAW_DATA> drawData;
     DRAW_DATA currentDrawData;
@@ -700,9 +854,12 @@ struct CB_SUBMISSION {
     VkFence fence;
 };
 
+// Device-level layout state of an image. layout is the layout the image was created or acquired in, and applies to
+// every subresource that has no entry in subresource_layouts.
 struct IMAGE_LAYOUT_NODE {
     VkImageLayout layout;
     VkFormat format;
+    SubresourceRangeMap<VkImageLayout> subresource_layouts;
 };
 
 // CHECK_DISABLED struct is a container for bools that can block validation checks from being performed.
@@ -802,8 +959,6 @@ bool ValidateCmd(layer_data *my_data, GLOBAL_CB_NODE *pCB, const CMD_TYPE cmd, c
 bool insideRenderPass(const layer_data *my_data, GLOBAL_CB_NODE *pCB, const char *apiName, UNIQUE_VALIDATION_ERROR_CODE msgCode);
 void SetImageMemoryValid(layer_data *dev_data, IMAGE_STATE *image_state, bool valid);
 bool outsideRenderPass(const layer_data *my_data, GLOBAL_CB_NODE *pCB, const char *apiName, UNIQUE_VALIDATION_ERROR_CODE msgCode);
-void SetLayout(GLOBAL_CB_NODE *pCB, ImageSubresourcePair imgpair, const IMAGE_CMD_BUF_LAYOUT_NODE &node);
-void SetLayout(GLOBAL_CB_NODE *pCB, ImageSubresourcePair imgpair, const VkImageLayout &layout);
 bool ValidateImageMemoryIsValid(layer_data *dev_data, IMAGE_STATE *image_state, const char *functionName);
 bool ValidateImageSampleCount(layer_data *dev_data, IMAGE_STATE *image_state, VkSampleCountFlagBits sample_count,
                               const char *location, UNIQUE_VALIDATION_ERROR_CODE msgCode);
@@ -823,9 +978,8 @@ const debug_report_data *GetReportData(const layer_data *);
 const VkPhysicalDeviceProperties *GetPhysicalDeviceProperties(layer_data *);
 const CHECK_DISABLED *GetDisables(layer_data *);
 std::unordered_map<VkImage, std::unique_ptr<IMAGE_STATE>> *GetImageMap(core_validation::layer_data *);
-std::unordered_map<VkImage, std::vector<ImageSubresourcePair>> *GetImageSubresourceMap(layer_data *);
-std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> *GetImageLayoutMap(layer_data *);
-std::unordered_map<ImageSubresourcePair, IMAGE_LAYOUT_NODE> const *GetImageLayoutMap(layer_data const *);
+std::unordered_map<VkImage, IMAGE_LAYOUT_NODE> *GetImageLayoutMap(layer_data *);
+std::unordered_map<VkImage, IMAGE_LAYOUT_NODE> const *GetImageLayoutMap(layer_data const *);
 std::unordered_map<VkBuffer, std::unique_ptr<BUFFER_STATE>> *GetBufferMap(layer_data *device_data);
 std::unordered_map<VkBufferView, std::unique_ptr<BUFFER_VIEW_STATE>> *GetBufferViewMap(layer_data *device_data);
 std::unordered_map<VkImageView, std::unique_ptr<IMAGE_VIEW_STATE>> *GetImageViewMap(layer_data *device_data);
@@ -25,9 +25,66 @@
 #include "vk_enum_string_helper.h"
 #include "vk_safe_struct.h"
 #include "buffer_validation.h"
+#include <atomic>
+#include <mutex>
 #include <sstream>
 #include <algorithm>
 
+cvdescriptorset::DescriptorSetLayoutDef::DescriptorSetLayoutDef(std::vector<Binding> &&bindings)
+    : bindings_(std::move(bindings)), hash_(0) {
+    for (const auto &binding : bindings_) {
+        hash_ = hash_ * 31 + binding.binding;
+        hash_ = hash_ * 31 + binding.type;
+        hash_ = hash_ * 31 + binding.descriptor_count;
+        hash_ = hash_ * 31 + binding.stage_flags;
+    }
+}
+
+// Live definitions by hash. Entries are weak so a definition goes away with the last layout using it, at which point its
+// deleter drops the expired entries from its bucket. Never destroyed, since layouts of devices the app leaked can outlive
+// static destruction.
+static std::mutex layout_def_lock;
+static auto &layout_defs = *new std::unordered_multimap<size_t, std::weak_ptr<cvdescriptorset::DescriptorSetLayoutDef const>>;
+
+static void ReleaseLayoutDef(cvdescriptorset::DescriptorSetLayoutDef const *def) {
+    {
+        std::lock_guard<std::mutex> lock(layout_def_lock);
+        auto range = layout_defs.equal_range(def->GetHash());
+        for (auto it = range.first; it != range.second;) {
+            if (it->second.expired()) {
+                it = layout_defs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    delete def;
+}
+
+std::shared_ptr<cvdescriptorset::DescriptorSetLayoutDef const> cvdescriptorset::DescriptorSetLayoutDef::Get(
+    std::vector<Binding> &&bindings) {
+    // Definitions are kept in binding order, so equivalent layouts whose create infos list their bindings in different
+    // orders share one definition
+    std::sort(bindings.begin(), bindings.end(), [](const Binding &a, const Binding &b) { return a.binding < b.binding; });
+    DescriptorSetLayoutDef const *candidate = new DescriptorSetLayoutDef(std::move(bindings));
+    // Definitions looked at are kept alive until the lock is released, since dropping the last reference runs
+    // ReleaseLayoutDef
+    std::vector<std::shared_ptr<DescriptorSetLayoutDef const>> existing;
+    std::lock_guard<std::mutex> lock(layout_def_lock);
+    auto range = layout_defs.equal_range(candidate->GetHash());
+    for (auto it = range.first; it != range.second; ++it) {
+        auto def = it->second.lock();
+        if (def && *def == *candidate) {
+            delete candidate;
+            return def;
+        }
+        existing.push_back(std::move(def));
+    }
+    std::shared_ptr<DescriptorSetLayoutDef const> def(candidate, ReleaseLayoutDef);
+    layout_defs.emplace(def->GetHash(), def);
+    return def;
+}
+
 // Construct DescriptorSetLayout instance from given create info
 cvdescriptorset::DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo *p_create_info,
                                                           const VkDescriptorSetLayout layout)
@@ -81,6 +138,12 @@ cvdescriptorset::DescriptorSetLayout::DescriptorSetLayout(const VkDescriptorSetL
         binding_to_dynamic_array_idx_map_[bc_pair.first] = dyn_array_idx;
         dyn_array_idx += bc_pair.second;
     }
+    std::vector<DescriptorSetLayoutDef::Binding> def_bindings;
+    def_bindings.reserve(bindings_.size());
+    for (const auto &binding : bindings_) {
+        def_bindings.push_back({binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags});
+    }
+    def_ = DescriptorSetLayoutDef::Get(std::move(def_bindings));
 }
 
 // Validate descriptor set layout create info
@@ -211,8 +274,8 @@ VkSampler const *cvdescriptorset::DescriptorSetLayout::GetImmutableSamplerPtrFro
 //  else return false and fill in error_msg will description of what causes incompatibility
 bool cvdescriptorset::DescriptorSetLayout::IsCompatible(DescriptorSetLayout const *const rh_ds_layout,
                                                         std::string *error_msg) const {
-    // Trivial case
-    if (layout_ == rh_ds_layout->GetDescriptorSetLayout()) return true;
+    // Trivial case, and the common one of separately created layouts with identical bindings
+    if (layout_ == rh_ds_layout->GetDescriptorSetLayout() || def_ == rh_ds_layout->def_) return true;
     if (descriptor_count_ != rh_ds_layout->descriptor_count_) {
         std::stringstream error_str;
         error_str << "DescriptorSetLayout " << layout_ << " has " << descriptor_count_ << " descriptors, but DescriptorSetLayout "
@@ -222,7 +285,7 @@ bool cvdescriptorset::DescriptorSetLayout::IsCompatible(DescriptorSetLayout cons
     }
     // Descriptor counts match so need to go through bindings one-by-one
     //  and verify that type and stageFlags match
-    for (auto binding : bindings_) {
+    for (const auto &binding : bindings_) {
         // TODO : Do we also need to check immutable samplers?
         // VkDescriptorSetLayoutBinding *rh_binding;
         if (binding.descriptorCount != rh_ds_layout->GetDescriptorCountFromBinding(binding.binding)) {
@@ -309,18 +372,58 @@ bool cvdescriptorset::DescriptorSetLayout::VerifyUpdateConsistency(uint32_t curr
     return true;
 }
 
+// Source of DescriptorSet change counts, shared by all sets
+static std::atomic<uint64_t> descriptor_set_change_counter(0);
+
 cvdescriptorset::AllocateDescriptorSetsData::AllocateDescriptorSetsData(uint32_t count)
     : required_descriptors_by_type{}, layout_nodes(count, nullptr) {}
 
 cvdescriptorset::DescriptorSet::DescriptorSet(const VkDescriptorSet set, const VkDescriptorPool pool,
                                               const std::shared_ptr<DescriptorSetLayout const> &layout, const layer_data *dev_data)
     : some_update_(false),
+      change_count_(++descriptor_set_change_counter),
       set_(set),
       pool_state_(nullptr),
       p_layout_(layout),
       device_data_(dev_data),
       limits_(GetPhysDevProperties(dev_data)->properties.limits) {
     pool_state_ = GetDescriptorPoolState(dev_data, pool);
+    // Size each descriptor class's storage up front so it is allocated once and never moves
+    uint32_t class_counts[GeneralBuffer + 1] = {};
+    for (uint32_t i = 0; i < p_layout_->GetBindingCount(); ++i) {
+        switch (p_layout_->GetTypeFromIndex(i)) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+                class_counts[PlainSampler] += p_layout_->GetDescriptorCountFromIndex(i);
+                break;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                class_counts[ImageSampler] += p_layout_->GetDescriptorCountFromIndex(i);
+                break;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                class_counts[Image] += p_layout_->GetDescriptorCountFromIndex(i);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                class_counts[TexelBuffer] += p_layout_->GetDescriptorCountFromIndex(i);
+                break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                class_counts[GeneralBuffer] += p_layout_->GetDescriptorCountFromIndex(i);
+                break;
+            default:
+                break;
+        }
+    }
+    sampler_descriptors_.reserve(class_counts[PlainSampler]);
+    image_sampler_descriptors_.reserve(class_counts[ImageSampler]);
+    image_descriptors_.reserve(class_counts[Image]);
+    texel_descriptors_.reserve(class_counts[TexelBuffer]);
+    buffer_descriptors_.reserve(class_counts[GeneralBuffer]);
+    descriptors_.reserve(p_layout_->GetTotalDescriptorCount());
+
     // Foreach binding, create default descriptors of given type
     for (uint32_t i = 0; i < p_layout_->GetBindingCount(); ++i) {
         auto type = p_layout_->GetTypeFromIndex(i);
@@ -329,10 +432,11 @@ cvdescriptorset::DescriptorSet::DescriptorSet(const VkDescriptorSet set, const V
                 auto immut_sampler = p_layout_->GetImmutableSamplerPtrFromIndex(i);
                 for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di) {
                     if (immut_sampler) {
-                        descriptors_.emplace_back(new SamplerDescriptor(immut_sampler + di));
+                        sampler_descriptors_.emplace_back(immut_sampler + di);
                         some_update_ = true;  // Immutable samplers are updated at creation
                     } else
-                        descriptors_.emplace_back(new SamplerDescriptor(nullptr));
+                        sampler_descriptors_.emplace_back(nullptr);
+                    descriptors_.push_back(&sampler_descriptors_.back());
                 }
                 break;
             }
@@ -340,10 +444,11 @@ cvdescriptorset::DescriptorSet::DescriptorSet(const VkDescriptorSet set, const V
                 auto immut = p_layout_->GetImmutableSamplerPtrFromIndex(i);
                 for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di) {
                     if (immut) {
-                        descriptors_.emplace_back(new ImageSamplerDescriptor(immut + di));
+                        image_sampler_descriptors_.emplace_back(immut + di);
                         some_update_ = true;  // Immutable samplers are updated at creation
                     } else
-                        descriptors_.emplace_back(new ImageSamplerDescriptor(nullptr));
+                        image_sampler_descriptors_.emplace_back(nullptr);
+                    descriptors_.push_back(&image_sampler_descriptors_.back());
                 }
                 break;
             }
@@ -351,20 +456,26 @@ cvdescriptorset::DescriptorSet::DescriptorSet(const VkDescriptorSet set, const V
             case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
             case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
             case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di)
-                    descriptors_.emplace_back(new ImageDescriptor(type));
+                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di) {
+                    image_descriptors_.emplace_back(type);
+                    descriptors_.push_back(&image_descriptors_.back());
+                }
                 break;
             case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
             case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di)
-                    descriptors_.emplace_back(new TexelDescriptor(type));
+                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di) {
+                    texel_descriptors_.emplace_back(type);
+                    descriptors_.push_back(&texel_descriptors_.back());
+                }
                 break;
             case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
             case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
             case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
             case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di)
-                    descriptors_.emplace_back(new BufferDescriptor(type));
+                for (uint32_t di = 0; di < p_layout_->GetDescriptorCountFromIndex(i); ++di) {
+                    buffer_descriptors_.emplace_back(type);
+                    descriptors_.push_back(&buffer_descriptors_.back());
+                }
                 break;
             default:
                 assert(0);  // Bad descriptor type specified
@@ -424,7 +535,7 @@ bool cvdescriptorset::DescriptorSet::ValidateDrawState(const std::map<uint32_t,
                 auto descriptor_class = descriptors_[i]->GetClass();
                 if (descriptor_class == GeneralBuffer) {
                     // Verify that buffers are valid
-                    auto buffer = static_cast<BufferDescriptor *>(descriptors_[i].get())->GetBuffer();
+                    auto buffer = static_cast<BufferDescriptor *>(descriptors_[i])->GetBuffer();
                     auto buffer_node = GetBufferState(device_data_, buffer);
                     if (!buffer_node) {
                         std::stringstream error_str;
@@ -446,8 +557,8 @@ bool cvdescriptorset::DescriptorSet::ValidateDrawState(const std::map<uint32_t,
                     if (descriptors_[i]->IsDynamic()) {
                         // Validate that dynamic offsets are within the buffer
                         auto buffer_size = buffer_node->createInfo.size;
-                        auto range = static_cast<BufferDescriptor *>(descriptors_[i].get())->GetRange();
-                        auto desc_offset = static_cast<BufferDescriptor *>(descriptors_[i].get())->GetOffset();
+                        auto range = static_cast<BufferDescriptor *>(descriptors_[i])->GetRange();
+                        auto desc_offset = static_cast<BufferDescriptor *>(descriptors_[i])->GetOffset();
                         auto dyn_offset = dynamic_offsets[GetDynamicOffsetIndexFromBinding(binding) + array_idx];
                         if (VK_WHOLE_SIZE == range) {
                             if ((dyn_offset + desc_offset) > buffer_size) {
@@ -475,11 +586,11 @@ bool cvdescriptorset::DescriptorSet::ValidateDrawState(const std::map<uint32_t,
                     VkImageView image_view;
                     VkImageLayout image_layout;
                     if (descriptor_class == ImageSampler) {
-                        image_view = static_cast<ImageSamplerDescriptor *>(descriptors_[i].get())->GetImageView();
-                        image_layout = static_cast<ImageSamplerDescriptor *>(descriptors_[i].get())->GetImageLayout();
+                        image_view = static_cast<ImageSamplerDescriptor *>(descriptors_[i])->GetImageView();
+                        image_layout = static_cast<ImageSamplerDescriptor *>(descriptors_[i])->GetImageLayout();
                     } else {
-                        image_view = static_cast<ImageDescriptor *>(descriptors_[i].get())->GetImageView();
-                        image_layout = static_cast<ImageDescriptor *>(descriptors_[i].get())->GetImageLayout();
+                        image_view = static_cast<ImageDescriptor *>(descriptors_[i])->GetImageView();
+                        image_layout = static_cast<ImageDescriptor *>(descriptors_[i])->GetImageLayout();
                     }
                     auto reqs = binding_pair.second;
 
@@ -561,14 +672,14 @@ uint32_t cvdescriptorset::DescriptorSet::GetStorageUpdates(const std::map<uint32
             if (Image == descriptors_[start_idx]->descriptor_class) {
                 for (uint32_t i = 0; i < p_layout_->GetDescriptorCountFromBinding(binding); ++i) {
                     if (descriptors_[start_idx + i]->updated) {
-                        image_set->insert(static_cast<ImageDescriptor *>(descriptors_[start_idx + i].get())->GetImageView());
+                        image_set->insert(static_cast<ImageDescriptor *>(descriptors_[start_idx + i])->GetImageView());
                         num_updates++;
                     }
                 }
             } else if (TexelBuffer == descriptors_[start_idx]->descriptor_class) {
                 for (uint32_t i = 0; i < p_layout_->GetDescriptorCountFromBinding(binding); ++i) {
                     if (descriptors_[start_idx + i]->updated) {
-                        auto bufferview = static_cast<TexelDescriptor *>(descriptors_[start_idx + i].get())->GetBufferView();
+                        auto bufferview = static_cast<TexelDescriptor *>(descriptors_[start_idx + i])->GetBufferView();
                         auto bv_state = GetBufferViewState(device_data_, bufferview);
                         if (bv_state) {
                             buffer_set->insert(bv_state->create_info.buffer);
@@ -579,7 +690,7 @@ uint32_t cvdescriptorset::DescriptorSet::GetStorageUpdates(const std::map<uint32
             } else if (GeneralBuffer == descriptors_[start_idx]->descriptor_class) {
                 for (uint32_t i = 0; i < p_layout_->GetDescriptorCountFromBinding(binding); ++i) {
                     if (descriptors_[start_idx + i]->updated) {
-                        buffer_set->insert(static_cast<BufferDescriptor *>(descriptors_[start_idx + i].get())->GetBuffer());
+                        buffer_set->insert(static_cast<BufferDescriptor *>(descriptors_[start_idx + i])->GetBuffer());
                         num_updates++;
                     }
                 }
@@ -611,6 +722,21 @@ void cvdescriptorset::DescriptorSet::PerformWriteUpdate(const VkWriteDescriptorS
         binding_being_updated++;
     }
     if (update->descriptorCount) some_update_ = true;
+    change_count_ = ++descriptor_set_change_counter;
+
+    InvalidateBoundCmdBuffers();
+}
+// Perform the update runs of a template, reading each descriptor's update info straight out of pData
+void cvdescriptorset::DescriptorSet::PerformTemplateUpdate(const std::vector<TEMPLATE_UPDATE_RUN> &update_runs,
+                                                           const void *pData) {
+    auto data = static_cast<const uint8_t *>(pData);
+    for (const auto &run : update_runs) {
+        for (uint32_t di = 0; di < run.count; ++di) {
+            descriptors_[run.dst_index + di]->TemplateUpdate(data + run.offset + di * run.stride);
+        }
+        if (run.count) some_update_ = true;
+    }
+    change_count_ = ++descriptor_set_change_counter;
 
     InvalidateBoundCmdBuffers();
 }
@@ -711,9 +837,10 @@ void cvdescriptorset::DescriptorSet::PerformCopyUpdate(const VkCopyDescriptorSet
     auto dst_start_idx = p_layout_->GetGlobalStartIndexFromBinding(update->dstBinding) + update->dstArrayElement;
     // Update parameters all look good so perform update
     for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-        descriptors_[dst_start_idx + di]->CopyUpdate(src_set->descriptors_[src_start_idx + di].get());
+        descriptors_[dst_start_idx + di]->CopyUpdate(src_set->descriptors_[src_start_idx + di]);
     }
     if (update->descriptorCount) some_update_ = true;
+    change_count_ = ++descriptor_set_change_counter;
 
     InvalidateBoundCmdBuffers();
 }
@@ -724,10 +851,10 @@ void cvdescriptorset::DescriptorSet::PerformCopyUpdate(const VkCopyDescriptorSet
 void cvdescriptorset::DescriptorSet::BindCommandBuffer(GLOBAL_CB_NODE *cb_node,
                                                        const std::map<uint32_t, descriptor_req> &binding_req_map) {
     // bind cb to this descriptor set
-    cb_bindings.insert(cb_node);
+    AddCommandBufferBinding(cb_node);
     // Add bindings for descriptor set, the set's pool, and individual objects in the set
     cb_node->object_bindings.insert({HandleToUint64(set_), kVulkanObjectTypeDescriptorSet});
-    pool_state_->cb_bindings.insert(cb_node);
+    pool_state_->AddCommandBufferBinding(cb_node);
     cb_node->object_bindings.insert({HandleToUint64(pool_state_->pool), kVulkanObjectTypeDescriptorPool});
     // For the active slots, use set# to look up descriptorSet from boundDescriptorSets, and bind all of that descriptor set's
     // resources
@@ -944,6 +1071,11 @@ void cvdescriptorset::SamplerDescriptor::CopyUpdate(const Descriptor *src) {
     updated = true;
 }
 
+void cvdescriptorset::SamplerDescriptor::TemplateUpdate(const void *info) {
+    sampler_ = static_cast<const VkDescriptorImageInfo *>(info)->sampler;
+    updated = true;
+}
+
 void cvdescriptorset::SamplerDescriptor::BindCommandBuffer(const layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
     if (!immutable_) {
         auto sampler_state = GetSamplerState(dev_data, sampler_);
@@ -981,6 +1113,14 @@ void cvdescriptorset::ImageSamplerDescriptor::CopyUpdate(const Descriptor *src)
     image_layout_ = image_layout;
 }
 
+void cvdescriptorset::ImageSamplerDescriptor::TemplateUpdate(const void *info) {
+    updated = true;
+    const auto &image_info = *static_cast<const VkDescriptorImageInfo *>(info);
+    sampler_ = image_info.sampler;
+    image_view_ = image_info.imageView;
+    image_layout_ = image_info.imageLayout;
+}
+
 void cvdescriptorset::ImageSamplerDescriptor::BindCommandBuffer(const layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
     // First add binding for any non-immutable sampler
     if (!immutable_) {
@@ -1016,6 +1156,13 @@ void cvdescriptorset::ImageDescriptor::CopyUpdate(const Descriptor *src) {
     image_layout_ = image_layout;
 }
 
+void cvdescriptorset::ImageDescriptor::TemplateUpdate(const void *info) {
+    updated = true;
+    const auto &image_info = *static_cast<const VkDescriptorImageInfo *>(info);
+    image_view_ = image_info.imageView;
+    image_layout_ = image_info.imageLayout;
+}
+
 void cvdescriptorset::ImageDescriptor::BindCommandBuffer(const layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
     // Add binding for image
     auto iv_state = GetImageViewState(dev_data, image_view_);
@@ -1053,6 +1200,14 @@ void cvdescriptorset::BufferDescriptor::CopyUpdate(const Descriptor *src) {
     range_ = buff_desc->range_;
 }
 
+void cvdescriptorset::BufferDescriptor::TemplateUpdate(const void *info) {
+    updated = true;
+    const auto &buffer_info = *static_cast<const VkDescriptorBufferInfo *>(info);
+    buffer_ = buffer_info.buffer;
+    offset_ = buffer_info.offset;
+    range_ = buffer_info.range;
+}
+
 void cvdescriptorset::BufferDescriptor::BindCommandBuffer(const layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
     auto buffer_node = GetBufferState(dev_data, buffer_);
     if (buffer_node) core_validation::AddCommandBufferBindingBuffer(dev_data, cb_node, buffer_node);
@@ -1074,6 +1229,11 @@ void cvdescriptorset::TexelDescriptor::CopyUpdate(const Descriptor *src) {
     buffer_view_ = static_cast<const TexelDescriptor *>(src)->buffer_view_;
 }
 
+void cvdescriptorset::TexelDescriptor::TemplateUpdate(const void *info) {
+    updated = true;
+    buffer_view_ = *static_cast<const VkBufferView *>(info);
+}
+
 void cvdescriptorset::TexelDescriptor::BindCommandBuffer(const layer_data *dev_data, GLOBAL_CB_NODE *cb_node) {
     auto bv_state = GetBufferViewState(dev_data, buffer_view_);
     if (bv_state) {
@@ -1162,71 +1322,50 @@ void cvdescriptorset::PerformUpdateDescriptorSets(const layer_data *dev_data, ui
         }
     }
 }
-// This helper function carries out the state updates for descriptor updates peformed via update templates. It basically collects
-// data and leverages the PerformUpdateDescriptor helper functions to do this.
-void cvdescriptorset::PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *device_data, VkDescriptorSet descriptorSet,
-                                                                 std::unique_ptr<TEMPLATE_STATE> const &template_state,
-                                                                 const void *pData) {
+// Resolve each template entry into runs of consecutive descriptors within one binding. An entry that runs past the end of
+// its binding continues at element 0 of the next binding with descriptors, as for vkUpdateDescriptorSets.
+void cvdescriptorset::CompileDescriptorUpdateTemplate(const layer_data *device_data, TEMPLATE_STATE *template_state) {
     auto const &create_info = template_state->create_info;
-
-    // Create a vector of write structs
-    std::vector<VkWriteDescriptorSet> desc_writes;
+    template_state->update_runs.clear();
+    // Push descriptor templates update no set, so there's nothing to resolve against
+    if (create_info.templateType != VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR) return;
     auto layout_obj = GetDescriptorSetLayout(device_data, create_info.descriptorSetLayout);
+    if (!layout_obj) return;
 
-    // Create a WriteDescriptorSet struct for each template update entry
     for (uint32_t i = 0; i < create_info.descriptorUpdateEntryCount; i++) {
-        auto binding_count = layout_obj->GetDescriptorCountFromBinding(create_info.pDescriptorUpdateEntries[i].dstBinding);
-        auto binding_being_updated = create_info.pDescriptorUpdateEntries[i].dstBinding;
-        auto dst_array_element = create_info.pDescriptorUpdateEntries[i].dstArrayElement;
-
-        for (uint32_t j = 0; j < create_info.pDescriptorUpdateEntries[i].descriptorCount; j++) {
-            desc_writes.emplace_back();
-            auto &write_entry = desc_writes.back();
-
-            size_t offset = create_info.pDescriptorUpdateEntries[i].offset + j * create_info.pDescriptorUpdateEntries[i].stride;
-            char *update_entry = (char *)(pData) + offset;
+        auto const &entry = create_info.pDescriptorUpdateEntries[i];
+        auto binding = entry.dstBinding;
+        auto array_element = entry.dstArrayElement;
+        auto descriptors_remaining = entry.descriptorCount;
+        size_t offset = entry.offset;
 
-            if (dst_array_element >= binding_count) {
-                dst_array_element = 0;
-                binding_being_updated = layout_obj->GetNextValidBinding(binding_being_updated);
+        while (descriptors_remaining && layout_obj->HasBinding(binding)) {
+            auto binding_count = layout_obj->GetDescriptorCountFromBinding(binding);
+            if (array_element < binding_count) {
+                uint32_t run_count = std::min(descriptors_remaining, binding_count - array_element);
+                TEMPLATE_UPDATE_RUN run = {layout_obj->GetGlobalStartIndexFromBinding(binding) + array_element, run_count, offset,
+                                           entry.stride};
+                template_state->update_runs.push_back(run);
+                descriptors_remaining -= run_count;
+                offset += run_count * entry.stride;
             }
-
-            write_entry.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            write_entry.pNext = NULL;
-            write_entry.dstSet = descriptorSet;
-            write_entry.dstBinding = binding_being_updated;
-            write_entry.dstArrayElement = dst_array_element;
-            write_entry.descriptorCount = 1;
-            write_entry.descriptorType = create_info.pDescriptorUpdateEntries[i].descriptorType;
-
-            switch (create_info.pDescriptorUpdateEntries[i].descriptorType) {
-                case VK_DESCRIPTOR_TYPE_SAMPLER:
-                case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-                case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
-                case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-                case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-                    write_entry.pImageInfo = reinterpret_cast<VkDescriptorImageInfo *>(update_entry);
-                    break;
-
-                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
-                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
-                    write_entry.pBufferInfo = reinterpret_cast<VkDescriptorBufferInfo *>(update_entry);
-                    break;
-
-                case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
-                case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
-                    write_entry.pTexelBufferView = reinterpret_cast<VkBufferView *>(update_entry);
-                    break;
-                default:
-                    assert(0);
-                    break;
-            }
-            dst_array_element++;
+            array_element = 0;
+            do {
+                binding++;
+            } while (layout_obj->HasBinding(binding) && !layout_obj->GetDescriptorCountFromBinding(binding));
         }
     }
-    PerformUpdateDescriptorSets(device_data, static_cast<uint32_t>(desc_writes.size()), desc_writes.data(), 0, NULL);
+}
+
+// This helper function carries out the state updates for descriptor updates peformed via update templates, applying the runs
+// compiled when the template was created directly to the set's descriptors.
+void cvdescriptorset::PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *device_data, VkDescriptorSet descriptorSet,
+                                                                 std::unique_ptr<TEMPLATE_STATE> const &template_state,
+                                                                 const void *pData) {
+    auto set_node = core_validation::GetSetNode(device_data, descriptorSet);
+    if (set_node) {
+        set_node->PerformTemplateUpdate(template_state->update_runs, pData);
+    }
 }
 // Validate the state for a given write update but don't actually perform the update
 //  If an error would occur for this update, return false and fill in details in error_msg string
@@ -1446,7 +1585,7 @@ bool cvdescriptorset::DescriptorSet::VerifyWriteUpdateContents(const VkWriteDesc
         }
         case VK_DESCRIPTOR_TYPE_SAMPLER: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                if (!descriptors_[index + di].get()->IsImmutableSampler()) {
+                if (!descriptors_[index + di]->IsImmutableSampler()) {
                     if (!ValidateSampler(update->pImageInfo[di].sampler, device_data_)) {
                         *error_code = VALIDATION_ERROR_15c0028a;
                         std::stringstream error_str;
@@ -1530,7 +1669,7 @@ bool cvdescriptorset::DescriptorSet::VerifyCopyUpdateContents(const VkCopyDescri
         case PlainSampler: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
                 if (!src_set->descriptors_[index + di]->IsImmutableSampler()) {
-                    auto update_sampler = static_cast<SamplerDescriptor *>(src_set->descriptors_[index + di].get())->GetSampler();
+                    auto update_sampler = static_cast<SamplerDescriptor *>(src_set->descriptors_[index + di])->GetSampler();
                     if (!ValidateSampler(update_sampler, device_data_)) {
                         *error_code = VALIDATION_ERROR_15c0028a;
                         std::stringstream error_str;
@@ -1546,7 +1685,7 @@ bool cvdescriptorset::DescriptorSet::VerifyCopyUpdateContents(const VkCopyDescri
         }
         case ImageSampler: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                auto img_samp_desc = static_cast<const ImageSamplerDescriptor *>(src_set->descriptors_[index + di].get());
+                auto img_samp_desc = static_cast<const ImageSamplerDescriptor *>(src_set->descriptors_[index + di]);
                 // First validate sampler
                 if (!img_samp_desc->IsImmutableSampler()) {
                     auto update_sampler = img_samp_desc->GetSampler();
@@ -1574,7 +1713,7 @@ bool cvdescriptorset::DescriptorSet::VerifyCopyUpdateContents(const VkCopyDescri
         }
         case Image: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                auto img_desc = static_cast<const ImageDescriptor *>(src_set->descriptors_[index + di].get());
+                auto img_desc = static_cast<const ImageDescriptor *>(src_set->descriptors_[index + di]);
                 auto image_view = img_desc->GetImageView();
                 auto image_layout = img_desc->GetImageLayout();
                 if (!ValidateImageUpdate(image_view, image_layout, type, device_data_, error_code, error_msg)) {
@@ -1588,7 +1727,7 @@ bool cvdescriptorset::DescriptorSet::VerifyCopyUpdateContents(const VkCopyDescri
         }
         case TexelBuffer: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                auto buffer_view = static_cast<TexelDescriptor *>(src_set->descriptors_[index + di].get())->GetBufferView();
+                auto buffer_view = static_cast<TexelDescriptor *>(src_set->descriptors_[index + di])->GetBufferView();
                 auto bv_state = GetBufferViewState(device_data_, buffer_view);
                 if (!bv_state) {
                     *error_code = VALIDATION_ERROR_15c00286;
@@ -1609,7 +1748,7 @@ bool cvdescriptorset::DescriptorSet::VerifyCopyUpdateContents(const VkCopyDescri
         }
         case GeneralBuffer: {
             for (uint32_t di = 0; di < update->descriptorCount; ++di) {
-                auto buffer = static_cast<BufferDescriptor *>(src_set->descriptors_[index + di].get())->GetBuffer();
+                auto buffer = static_cast<BufferDescriptor *>(src_set->descriptors_[index + di])->GetBuffer();
                 if (!ValidateBufferUsage(GetBufferState(device_data_, buffer), type, error_code, error_msg)) {
                     std::stringstream error_str;
                     error_str << "Attempted copy update to buffer descriptor failed due to: " << error_msg->c_str();
@@ -92,6 +92,37 @@ using core_validation::layer_data;
  *  global indices for the lowest binding#.
  */
 namespace cvdescriptorset {
+/*
+ * DescriptorSetLayoutDef class
+ *
+ * The part of a layout that decides set layout compatibility: the binding#, type, descriptor
+ *  count and stage flags of each binding, in binding order. Definitions are hash-consed, so
+ *  every live layout with the same definition shares one DescriptorSetLayoutDef object and
+ *  two such layouts can be proven compatible by comparing pointers.
+ */
+class DescriptorSetLayoutDef {
+   public:
+    struct Binding {
+        uint32_t binding;
+        VkDescriptorType type;
+        uint32_t descriptor_count;
+        VkShaderStageFlags stage_flags;
+        bool operator==(const Binding &rhs) const {
+            return binding == rhs.binding && type == rhs.type && descriptor_count == rhs.descriptor_count &&
+                   stage_flags == rhs.stage_flags;
+        }
+    };
+    // Return the shared definition for the given bindings, which may be in any order
+    static std::shared_ptr<DescriptorSetLayoutDef const> Get(std::vector<Binding> &&bindings);
+    size_t GetHash() const { return hash_; }
+    bool operator==(const DescriptorSetLayoutDef &rhs) const { return hash_ == rhs.hash_ && bindings_ == rhs.bindings_; }
+
+   private:
+    explicit DescriptorSetLayoutDef(std::vector<Binding> &&bindings);
+    std::vector<Binding> bindings_;
+    size_t hash_;
+};
+
 class DescriptorSetLayout {
    public:
     // Constructors and destructor
@@ -156,6 +187,7 @@ class DescriptorSetLayout {
     std::vector<safe_VkDescriptorSetLayoutBinding> bindings_;
     uint32_t descriptor_count_;  // total # descriptors in this layout
     uint32_t dynamic_descriptor_count_;
+    std::shared_ptr<DescriptorSetLayoutDef const> def_;
 };
 
 /*
@@ -173,6 +205,8 @@ class Descriptor {
     virtual ~Descriptor(){};
     virtual void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) = 0;
     virtual void CopyUpdate(const Descriptor *) = 0;
+    // Update from the VkDescriptorImageInfo, VkDescriptorBufferInfo or VkBufferView matching this descriptor's class
+    virtual void TemplateUpdate(const void *) = 0;
     // Create binding between resources of this descriptor and given cb_node
     virtual void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) = 0;
     virtual DescriptorClass GetClass() const { return descriptor_class; };
@@ -196,6 +230,7 @@ class SamplerDescriptor : public Descriptor {
     SamplerDescriptor(const VkSampler *);
     void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) override;
     void CopyUpdate(const Descriptor *) override;
+    void TemplateUpdate(const void *) override;
     void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) override;
     virtual bool IsImmutableSampler() const override { return immutable_; };
     VkSampler GetSampler() const { return sampler_; }
@@ -211,6 +246,7 @@ class ImageSamplerDescriptor : public Descriptor {
     ImageSamplerDescriptor(const VkSampler *);
     void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) override;
     void CopyUpdate(const Descriptor *) override;
+    void TemplateUpdate(const void *) override;
     void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) override;
     virtual bool IsImmutableSampler() const override { return immutable_; };
     VkSampler GetSampler() const { return sampler_; }
@@ -229,6 +265,7 @@ class ImageDescriptor : public Descriptor {
     ImageDescriptor(const VkDescriptorType);
     void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) override;
     void CopyUpdate(const Descriptor *) override;
+    void TemplateUpdate(const void *) override;
     void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) override;
     virtual bool IsStorage() const override { return storage_; }
     VkImageView GetImageView() const { return image_view_; }
@@ -245,6 +282,7 @@ class TexelDescriptor : public Descriptor {
     TexelDescriptor(const VkDescriptorType);
     void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) override;
     void CopyUpdate(const Descriptor *) override;
+    void TemplateUpdate(const void *) override;
     void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) override;
     virtual bool IsStorage() const override { return storage_; }
     VkBufferView GetBufferView() const { return buffer_view_; }
@@ -259,6 +297,7 @@ class BufferDescriptor : public Descriptor {
     BufferDescriptor(const VkDescriptorType);
     void WriteUpdate(const VkWriteDescriptorSet *, const uint32_t) override;
     void CopyUpdate(const Descriptor *) override;
+    void TemplateUpdate(const void *) override;
     void BindCommandBuffer(const core_validation::layer_data *, GLOBAL_CB_NODE *) override;
     virtual bool IsDynamic() const override { return dynamic_; }
     virtual bool IsStorage() const override { return storage_; }
@@ -286,6 +325,8 @@ bool ValidateUpdateDescriptorSets(const debug_report_data *, const core_validati
 // "Perform" does the update with the assumption that ValidateUpdateDescriptorSets() has passed for the given update
 void PerformUpdateDescriptorSets(const core_validation::layer_data *, uint32_t, const VkWriteDescriptorSet *, uint32_t,
                                  const VkCopyDescriptorSet *);
+// Resolve the entries of a newly created update template into its update_runs
+void CompileDescriptorUpdateTemplate(const layer_data *, TEMPLATE_STATE *);
 // Similar to PerformUpdateDescriptorSets, this function will do the same for updating via templates
 void PerformUpdateDescriptorSetsWithTemplateKHR(layer_data *, VkDescriptorSet, std::unique_ptr<TEMPLATE_STATE> const &,
                                                 const void *);
@@ -312,7 +353,9 @@ void PerformAllocateDescriptorSets(const VkDescriptorSetAllocateInfo *, const Vk
  *   index, binding, and global index.
  *
  * At construction a vector of Descriptor* is created with types corresponding to the
- *   layout. The primary operation performed on the descriptors is to update them
+ *   layout. The descriptors themselves live in one contiguous array per descriptor
+ *   class, sized up front from the layout, so creating a set costs a handful of
+ *   allocations regardless of its descriptor count. The primary operation performed on the descriptors is to update them
  *   via write or copy updates, and validate that the update contents are correct.
  *   In order to validate update contents, the DescriptorSet stores a bunch of ptrs
  *   to data maps where various Vulkan objects can be looked up. The management of
@@ -362,6 +405,8 @@ class DescriptorSet : public BASE_NODE {
                             UNIQUE_VALIDATION_ERROR_CODE *, std::string *);
     // Perform a CopyUpdate whose contents were just validated using ValidateCopyUpdate
     void PerformCopyUpdate(const VkCopyDescriptorSet *, const DescriptorSet *);
+    // Perform the update runs of a descriptor update template with the given pData
+    void PerformTemplateUpdate(const std::vector<TEMPLATE_UPDATE_RUN> &, const void *);
 
     std::shared_ptr<DescriptorSetLayout const> const GetLayout() const { return p_layout_; };
     VkDescriptorSet GetSet() const { return set_; };
@@ -383,6 +428,9 @@ class DescriptorSet : public BASE_NODE {
     };
     // Return true if any part of set has ever been updated
     bool IsUpdated() const { return some_update_; };
+    // Return a value that changes whenever the contents of this set change. Values are never reused across sets, so a set
+    // allocated at the address of a freed one can't be mistaken for it.
+    uint64_t GetChangeCount() const { return change_count_; };
 
    private:
     bool VerifyWriteUpdateContents(const VkWriteDescriptorSet *, const uint32_t, UNIQUE_VALIDATION_ERROR_CODE *,
@@ -395,10 +443,19 @@ class DescriptorSet : public BASE_NODE {
     // Private helper to set all bound cmd buffers to INVALID state
     void InvalidateBoundCmdBuffers();
     bool some_update_;  // has any part of the set ever been updated?
+    uint64_t change_count_;
     VkDescriptorSet set_;
     DESCRIPTOR_POOL_STATE *pool_state_;
     const std::shared_ptr<DescriptorSetLayout const> p_layout_;
-    std::vector<std::unique_ptr<Descriptor>> descriptors_;
+    // Storage for the descriptors, one array per class. Each is reserved to its final size before being filled, so the
+    // pointers in descriptors_ stay valid for the life of the set.
+    std::vector<SamplerDescriptor> sampler_descriptors_;
+    std::vector<ImageSamplerDescriptor> image_sampler_descriptors_;
+    std::vector<ImageDescriptor> image_descriptors_;
+    std::vector<TexelDescriptor> texel_descriptors_;
+    std::vector<BufferDescriptor> buffer_descriptors_;
+    // Descriptors in global index order
+    std::vector<Descriptor *> descriptors_;
     // Ptr to device data used for various data look-ups
     const core_validation::layer_data *device_data_;
     const VkPhysicalDeviceLimits limits_;
@@ -0,0 +1,149 @@
+/* Copyright (c) 2015-2017 The Khronos Group Inc.
+ * Copyright (c) 2015-2017 Valve Corporation
+ * Copyright (c) 2015-2017 LunarG, Inc.
+ * Copyright (C) 2015-2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef CORE_VALIDATION_IMAGE_LAYOUT_MAP_H_
+#define CORE_VALIDATION_IMAGE_LAYOUT_MAP_H_
+
+#include "vulkan/vulkan.h"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <stdint.h>
+
+// Image aspects that carry layout state, in the order used by the subresource key space below
+static const VkImageAspectFlagBits kImageLayoutAspects[] = {VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                            VK_IMAGE_ASPECT_STENCIL_BIT, VK_IMAGE_ASPECT_METADATA_BIT};
+static const uint32_t kImageLayoutAspectCount = sizeof(kImageLayoutAspects) / sizeof(kImageLayoutAspects[0]);
+
+// Subresource keys order an image's subresources by (aspect, mip level, array layer), so that any run of array layers
+// within a single mip level of a single aspect is one contiguous key range.
+inline uint64_t ImageSubresourceKey(uint32_t aspect_index, uint32_t mip_level, uint32_t array_layer) {
+    return (static_cast<uint64_t>(aspect_index) << 56) | (static_cast<uint64_t>(mip_level) << 32) | array_layer;
+}
+
+inline VkImageSubresource ImageSubresourceFromKey(uint64_t key) {
+    VkImageSubresource subresource;
+    subresource.aspectMask = kImageLayoutAspects[key >> 56];
+    subresource.mipLevel = static_cast<uint32_t>((key >> 32) & 0xFFFFFF);
+    subresource.arrayLayer = static_cast<uint32_t>(key);
+    return subresource;
+}
+
+// Per-image subresource state stored as non-overlapping [begin, end) runs of subresource keys. A transition of a whole
+// layer range is recorded as a single run instead of one entry per subresource, and adjacent runs holding equal values
+// are merged, so both storage and updates scale with the number of distinct ranges rather than subresources.
+template <typename T>
+class SubresourceRangeMap {
+   public:
+    struct Run {
+        uint64_t end;
+        T value;
+    };
+    typedef std::map<uint64_t, Run> RunMap;
+    typedef typename RunMap::const_iterator const_iterator;
+
+    const_iterator begin() const { return runs_.begin(); }
+    const_iterator end() const { return runs_.end(); }
+    bool empty() const { return runs_.empty(); }
+    void clear() { runs_.clear(); }
+
+    // Return the value stored for a single subresource key, or nullptr if there is none
+    const T *Find(uint64_t key) const {
+        auto it = runs_.upper_bound(key);
+        if (it == runs_.begin()) return nullptr;
+        --it;
+        return (key < it->second.end) ? &it->second.value : nullptr;
+    }
+
+    // Call func(begin, end, value) for each part of [begin, end), in key order. value is nullptr for parts with no entry.
+    template <typename Fn>
+    void ForEachInRange(uint64_t range_begin, uint64_t range_end, Fn &&func) const {
+        uint64_t pos = range_begin;
+        auto it = runs_.upper_bound(range_begin);
+        if (it != runs_.begin() && std::prev(it)->second.end > range_begin) --it;
+        for (; pos < range_end && it != runs_.end() && it->first < range_end; ++it) {
+            if (it->first > pos) {
+                func(pos, it->first, static_cast<const T *>(nullptr));
+                pos = it->first;
+            }
+            uint64_t run_end = std::min(it->second.end, range_end);
+            func(pos, run_end, &it->second.value);
+            pos = run_end;
+        }
+        if (pos < range_end) func(pos, range_end, static_cast<const T *>(nullptr));
+    }
+
+    // Apply update(value) to every stored value in [begin, end), and store fill_value for the parts with no entry
+    template <typename Fn>
+    void Update(uint64_t range_begin, uint64_t range_end, Fn &&update, const T &fill_value) {
+        if (range_begin >= range_end) return;
+        Split(range_begin);
+        Split(range_end);
+        uint64_t pos = range_begin;
+        auto it = runs_.lower_bound(range_begin);
+        while (pos < range_end) {
+            if (it == runs_.end() || it->first > pos) {
+                uint64_t gap_end = (it == runs_.end()) ? range_end : std::min(it->first, range_end);
+                runs_.insert(it, std::make_pair(pos, Run{gap_end, fill_value}));
+                pos = gap_end;
+            } else {
+                update(it->second.value);
+                pos = it->second.end;
+                ++it;
+            }
+        }
+        Coalesce(range_begin, range_end);
+    }
+
+    // Overwrite every value in [begin, end)
+    void Set(uint64_t range_begin, uint64_t range_end, const T &value) {
+        Update(range_begin, range_end, [&value](T &stored) { stored = value; }, value);
+    }
+
+   private:
+    // Make sure no run straddles key, so that key starts a run or falls in a gap
+    void Split(uint64_t key) {
+        auto it = runs_.upper_bound(key);
+        if (it == runs_.begin()) return;
+        --it;
+        if (it->first < key && key < it->second.end) {
+            Run tail = {it->second.end, it->second.value};
+            it->second.end = key;
+            runs_.insert(std::next(it), std::make_pair(key, tail));
+        }
+    }
+
+    // Merge adjacent runs with equal values in and around [begin, end]
+    void Coalesce(uint64_t range_begin, uint64_t range_end) {
+        auto it = runs_.lower_bound(range_begin);
+        if (it != runs_.begin()) --it;
+        while (it != runs_.end()) {
+            auto next = std::next(it);
+            if (next == runs_.end() || next->first > range_end) break;
+            if (it->second.end == next->first && it->second.value == next->second.value) {
+                it->second.end = next->second.end;
+                runs_.erase(next);
+            } else {
+                it = next;
+            }
+        }
+    }
+
+    RunMap runs_;
+};
+
+#endif  // CORE_VALIDATION_IMAGE_LAYOUT_MAP_H_
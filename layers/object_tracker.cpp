@@ -53,6 +53,40 @@ static void InitObjectTracker(layer_data *my_data, const VkAllocationCallbacks *
     layer_debug_actions(my_data->report_data, my_data->logging_callback, pAllocator, "lunarg_object_tracker");
 }
 
+// Add node to an object map, counting the map as an owner of its handle in object_owner_count
+static void InsertObjectNode(object_map_type &object_map, OBJTRACK_NODE *node) {
+    OBJTRACK_NODE *&slot = object_map[node->handle];
+    if (slot) {
+        object_node_pool.Free(slot);
+    } else {
+        object_owner_count[ObjTrackHandleKey{node->handle, node->object_type}]++;
+    }
+    slot = node;
+}
+
+// Remove a node from its object map and return it to the pool
+static object_map_type::iterator EraseObjectNode(object_map_type &object_map, object_map_type::iterator item) {
+    OBJTRACK_NODE *node = item->second;
+    auto owner = object_owner_count.find(ObjTrackHandleKey{node->handle, node->object_type});
+    if ((owner != object_owner_count.end()) && (--owner->second == 0)) {
+        object_owner_count.erase(owner);
+    }
+    object_node_pool.Free(node);
+    return object_map.erase(item);
+}
+
+// Release every node still tracked by an instance or device that is going away
+static void EraseAllObjectNodes(layer_data *data) {
+    for (auto &object_map : data->object_map) {
+        for (auto item = object_map.begin(); item != object_map.end();) {
+            item = EraseObjectNode(object_map, item);
+        }
+    }
+    for (auto item = data->swapchainImageMap.begin(); item != data->swapchainImageMap.end();) {
+        item = EraseObjectNode(data->swapchainImageMap, item);
+    }
+}
+
 // Add new queue to head of global queue list
 static void AddQueueInfo(VkDevice device, uint32_t queue_node_index, VkQueue queue) {
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
@@ -93,8 +127,7 @@ static void DestroyQueueDataStructures(VkDevice device) {
                 queue->second->handle, __LINE__, OBJTRACK_NONE, LayerName,
                 "OBJ_STAT Destroy Queue obj 0x%" PRIxLEAST64 " (%" PRIu64 " total objs remain & %" PRIu64 " Queue objs).",
                 queue->second->handle, device_data->num_total_objects, device_data->num_objects[obj_index]);
-        delete queue->second;
-        queue = device_data->object_map[kVulkanObjectTypeQueue].erase(queue);
+        queue = EraseObjectNode(device_data->object_map[kVulkanObjectTypeQueue], queue);
     }
 }
 
@@ -126,7 +159,7 @@ static void AllocateCommandBuffer(VkDevice device, const VkCommandPool command_p
             "OBJ[0x%" PRIxLEAST64 "] : CREATE %s object 0x%" PRIxLEAST64, object_track_index++,
             "VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT", HandleToUint64(command_buffer));
 
-    OBJTRACK_NODE *pNewObjNode = new OBJTRACK_NODE;
+    OBJTRACK_NODE *pNewObjNode = object_node_pool.Allocate();
     pNewObjNode->object_type = kVulkanObjectTypeCommandBuffer;
     pNewObjNode->handle = HandleToUint64(command_buffer);
     pNewObjNode->parent_object = HandleToUint64(command_pool);
@@ -135,7 +168,7 @@ static void AllocateCommandBuffer(VkDevice device, const VkCommandPool command_p
     } else {
         pNewObjNode->status = OBJSTATUS_NONE;
     }
-    device_data->object_map[kVulkanObjectTypeCommandBuffer][HandleToUint64(command_buffer)] = pNewObjNode;
+    InsertObjectNode(device_data->object_map[kVulkanObjectTypeCommandBuffer], pNewObjNode);
     device_data->num_objects[kVulkanObjectTypeCommandBuffer]++;
     device_data->num_total_objects++;
 }
@@ -173,12 +206,12 @@ static void AllocateDescriptorSet(VkDevice device, VkDescriptorPool descriptor_p
             "OBJ[0x%" PRIxLEAST64 "] : CREATE %s object 0x%" PRIxLEAST64, object_track_index++,
             "VK_DEBUG_REPORT_OBJECT_TYPE_DESCRIPTOR_SET_EXT", HandleToUint64(descriptor_set));
 
-    OBJTRACK_NODE *pNewObjNode = new OBJTRACK_NODE;
+    OBJTRACK_NODE *pNewObjNode = object_node_pool.Allocate();
     pNewObjNode->object_type = kVulkanObjectTypeDescriptorSet;
     pNewObjNode->status = OBJSTATUS_NONE;
     pNewObjNode->handle = HandleToUint64(descriptor_set);
     pNewObjNode->parent_object = HandleToUint64(descriptor_pool);
-    device_data->object_map[kVulkanObjectTypeDescriptorSet][HandleToUint64(descriptor_set)] = pNewObjNode;
+    InsertObjectNode(device_data->object_map[kVulkanObjectTypeDescriptorSet], pNewObjNode);
     device_data->num_objects[kVulkanObjectTypeDescriptorSet]++;
     device_data->num_total_objects++;
 }
@@ -215,19 +248,17 @@ static void CreateQueue(VkDevice device, VkQueue vkObj) {
             HandleToUint64(vkObj), __LINE__, OBJTRACK_NONE, LayerName, "OBJ[0x%" PRIxLEAST64 "] : CREATE %s object 0x%" PRIxLEAST64,
             object_track_index++, "VK_DEBUG_REPORT_OBJECT_TYPE_QUEUE_EXT", HandleToUint64(vkObj));
 
-    OBJTRACK_NODE *p_obj_node = NULL;
     auto queue_item = device_data->object_map[kVulkanObjectTypeQueue].find(HandleToUint64(vkObj));
     if (queue_item == device_data->object_map[kVulkanObjectTypeQueue].end()) {
-        p_obj_node = new OBJTRACK_NODE;
-        device_data->object_map[kVulkanObjectTypeQueue][HandleToUint64(vkObj)] = p_obj_node;
+        OBJTRACK_NODE *p_obj_node = object_node_pool.Allocate();
+        p_obj_node->object_type = kVulkanObjectTypeQueue;
+        p_obj_node->handle = HandleToUint64(vkObj);
+        InsertObjectNode(device_data->object_map[kVulkanObjectTypeQueue], p_obj_node);
         device_data->num_objects[kVulkanObjectTypeQueue]++;
         device_data->num_total_objects++;
     } else {
-        p_obj_node = queue_item->second;
+        queue_item->second->status = OBJSTATUS_NONE;
     }
-    p_obj_node->object_type = kVulkanObjectTypeQueue;
-    p_obj_node->status = OBJSTATUS_NONE;
-    p_obj_node->handle = HandleToUint64(vkObj);
 }
 
 static void CreateSwapchainImageObject(VkDevice dispatchable_object, VkImage swapchain_image, VkSwapchainKHR swapchain) {
@@ -237,12 +268,12 @@ static void CreateSwapchainImageObject(VkDevice dispatchable_object, VkImage swa
             "OBJ[0x%" PRIxLEAST64 "] : CREATE %s object 0x%" PRIxLEAST64, object_track_index++, "SwapchainImage",
             HandleToUint64(swapchain_image));
 
-    OBJTRACK_NODE *pNewObjNode = new OBJTRACK_NODE;
+    OBJTRACK_NODE *pNewObjNode = object_node_pool.Allocate();
     pNewObjNode->object_type = kVulkanObjectTypeImage;
     pNewObjNode->status = OBJSTATUS_NONE;
     pNewObjNode->handle = HandleToUint64(swapchain_image);
     pNewObjNode->parent_object = HandleToUint64(swapchain);
-    device_data->swapchainImageMap[HandleToUint64(swapchain_image)] = pNewObjNode;
+    InsertObjectNode(device_data->swapchainImageMap, pNewObjNode);
 }
 
 template <typename T1, typename T2>
@@ -258,12 +289,12 @@ static void CreateObject(T1 dispatchable_object, T2 object, VulkanObjectType obj
                 OBJTRACK_NONE, LayerName, "OBJ[0x%" PRIxLEAST64 "] : CREATE %s object 0x%" PRIxLEAST64, object_track_index++,
                 object_string[object_type], object_handle);
 
-        OBJTRACK_NODE *pNewObjNode = new OBJTRACK_NODE;
+        OBJTRACK_NODE *pNewObjNode = object_node_pool.Allocate();
         pNewObjNode->object_type = object_type;
         pNewObjNode->status = custom_allocator ? OBJSTATUS_CUSTOM_ALLOCATOR : OBJSTATUS_NONE;
         pNewObjNode->handle = object_handle;
 
-        instance_data->object_map[object_type][object_handle] = pNewObjNode;
+        InsertObjectNode(instance_data->object_map[object_type], pNewObjNode);
         instance_data->num_objects[object_type]++;
         instance_data->num_total_objects++;
     }
@@ -310,8 +341,7 @@ static void DestroyObject(T1 dispatchable_object, T2 object, VulkanObjectType ob
                         object_string[object_type], object_handle, validation_error_map[expected_default_allocator_code]);
             }
 
-            delete pNode;
-            device_data->object_map[object_type].erase(item);
+            EraseObjectNode(device_data->object_map[object_type], item);
         } else {
             log_msg(device_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, object_handle,
                     __LINE__, OBJTRACK_UNKNOWN_OBJECT, LayerName,
@@ -337,25 +367,16 @@ static bool ValidateObject(T1 dispatchable_object, T2 object, VulkanObjectType o
         // If object is an image, also look for it in the swapchain image map
         if ((object_type != kVulkanObjectTypeImage) ||
             (device_data->swapchainImageMap.find(object_handle) == device_data->swapchainImageMap.end())) {
-            // Object not found, look for it in other device object maps
-            for (auto other_device_data : layer_data_map) {
-                if (other_device_data.second != device_data) {
-                    if (other_device_data.second->object_map[object_type].find(object_handle) !=
-                            other_device_data.second->object_map[object_type].end() ||
-                        (object_type == kVulkanObjectTypeImage &&
-                         other_device_data.second->swapchainImageMap.find(object_handle) !=
-                             other_device_data.second->swapchainImageMap.end())) {
-                        // Object found on other device, report an error if object has a device parent error code
-                        if (wrong_device_code != VALIDATION_ERROR_UNDEFINED) {
-                            return log_msg(device_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, debug_object_type,
-                                           object_handle, __LINE__, wrong_device_code, LayerName,
-                                           "Object 0x%" PRIxLEAST64
-                                           " was not created, allocated or retrieved from the correct device. %s",
-                                           object_handle, validation_error_map[wrong_device_code]);
-                        } else {
-                            return false;
-                        }
-                    }
+            // Object not found here, so any map still holding it belongs to another device
+            if (object_owner_count.count(ObjTrackHandleKey{object_handle, object_type})) {
+                // Object found on other device, report an error if object has a device parent error code
+                if (wrong_device_code != VALIDATION_ERROR_UNDEFINED) {
+                    return log_msg(device_data->report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, debug_object_type, object_handle,
+                                   __LINE__, wrong_device_code, LayerName,
+                                   "Object 0x%" PRIxLEAST64 " was not created, allocated or retrieved from the correct device. %s",
+                                   object_handle, validation_error_map[wrong_device_code]);
+                } else {
+                    return false;
                 }
             }
             // Report an error if object was not found anywhere
@@ -376,7 +397,7 @@ static void DeviceReportUndestroyedObjects(VkDevice device, VulkanObjectType obj
                 __LINE__, error_code, LayerName,
                 "OBJ ERROR : For device 0x%" PRIxLEAST64 ", %s object 0x%" PRIxLEAST64 " has not been destroyed. %s",
                 HandleToUint64(device), object_string[object_type], object_info->handle, validation_error_map[error_code]);
-        item = device_data->object_map[object_type].erase(item);
+        item = EraseObjectNode(device_data->object_map[object_type], item);
     }
 }
 
@@ -451,7 +472,10 @@ VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocati
         DeviceReportUndestroyedObjects(device, kVulkanObjectTypeObjectTableNVX, VALIDATION_ERROR_258004ea);
         DeviceReportUndestroyedObjects(device, kVulkanObjectTypeIndirectCommandsLayoutNVX, VALIDATION_ERROR_258004ea);
     }
-    instance_data->object_map[kVulkanObjectTypeDevice].clear();
+    for (auto iit = instance_data->object_map[kVulkanObjectTypeDevice].begin();
+         iit != instance_data->object_map[kVulkanObjectTypeDevice].end();) {
+        iit = EraseObjectNode(instance_data->object_map[kVulkanObjectTypeDevice], iit);
+    }
 
     VkLayerInstanceDispatchTable *pInstanceTable = get_dispatch_table(ot_instance_table_map, instance);
     pInstanceTable->DestroyInstance(instance, pAllocator);
@@ -473,6 +497,7 @@ VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocati
     }
 
     layer_debug_report_destroy_instance(instance_data->report_data);
+    EraseAllObjectNodes(instance_data);
     FreeLayerDataPtr(key, layer_data_map);
 
     lock.unlock();
@@ -517,6 +542,8 @@ VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCall
 
     // Clean up Queue's MemRef Linked Lists
     DestroyQueueDataStructures(device);
+    // Release swapchain images and any other objects the device still tracks
+    EraseAllObjectNodes(GetLayerDataPtr(get_dispatch_key(device), layer_data_map));
 
     lock.unlock();
 
@@ -1901,8 +1928,9 @@ VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBuffer(VkCommandBuffer command_buffer
         skip |= ValidateObject(command_buffer, command_buffer, kVulkanObjectTypeCommandBuffer, false, VALIDATION_ERROR_16e02401,
                                VALIDATION_ERROR_UNDEFINED);
         if (begin_info) {
-            OBJTRACK_NODE *pNode = device_data->object_map[kVulkanObjectTypeCommandBuffer][HandleToUint64(command_buffer)];
-            if ((begin_info->pInheritanceInfo) && (pNode->status & OBJSTATUS_COMMAND_BUFFER_SECONDARY) &&
+            auto cb_item = device_data->object_map[kVulkanObjectTypeCommandBuffer].find(HandleToUint64(command_buffer));
+            if ((begin_info->pInheritanceInfo) && (cb_item != device_data->object_map[kVulkanObjectTypeCommandBuffer].end()) &&
+                (cb_item->second->status & OBJSTATUS_COMMAND_BUFFER_SECONDARY) &&
                 (begin_info->flags & VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT)) {
                 skip |= ValidateObject(command_buffer, begin_info->pInheritanceInfo->framebuffer, kVulkanObjectTypeFramebuffer,
                                        true, VALIDATION_ERROR_0280006e, VALIDATION_ERROR_02a00009);
@@ -3220,6 +3248,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDebugReportCallbackEXT(VkInstance instance,
     if (VK_SUCCESS == result) {
         layer_data *instance_data = GetLayerDataPtr(get_dispatch_key(instance), layer_data_map);
         result = layer_create_msg_callback(instance_data->report_data, false, pCreateInfo, pAllocator, pCallback);
+        std::lock_guard<std::mutex> lock(global_lock);
         CreateObject(instance, *pCallback, kVulkanObjectTypeDebugReportCallbackEXT, pAllocator);
     }
     return result;
@@ -3231,6 +3260,7 @@ VKAPI_ATTR void VKAPI_CALL DestroyDebugReportCallbackEXT(VkInstance instance, Vk
     pInstanceTable->DestroyDebugReportCallbackEXT(instance, msgCallback, pAllocator);
     layer_data *instance_data = GetLayerDataPtr(get_dispatch_key(instance), layer_data_map);
     layer_destroy_msg_callback(instance_data->report_data, msgCallback, pAllocator);
+    std::lock_guard<std::mutex> lock(global_lock);
     DestroyObject(instance, msgCallback, kVulkanObjectTypeDebugReportCallbackEXT, pAllocator, VALIDATION_ERROR_242009b4,
                   VALIDATION_ERROR_242009b6);
 }
@@ -3379,6 +3409,7 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(const VkInstanceCreateInfo *pCreat
 
     InitObjectTracker(instance_data, pAllocator);
 
+    std::lock_guard<std::mutex> lock(global_lock);
     CreateObject(*pInstance, *pInstance, kVulkanObjectTypeInstance, pAllocator);
 
     return result;
@@ -3588,9 +3619,7 @@ VKAPI_ATTR void VKAPI_CALL DestroySwapchainKHR(VkDevice device, VkSwapchainKHR s
     while (itr != device_data->swapchainImageMap.end()) {
         OBJTRACK_NODE *pNode = (*itr).second;
         if (pNode->parent_object == HandleToUint64(swapchain)) {
-            delete pNode;
-            auto delete_item = itr++;
-            device_data->swapchainImageMap.erase(delete_item);
+            itr = EraseObjectNode(device_data->swapchainImageMap, itr);
         } else {
             ++itr;
         }
@@ -20,7 +20,9 @@
  * Author: Tobin Ehlis <tobin@lunarg.com>
  */
 
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "vk_enum_string_helper.h"
 #include "vk_layer_extension_utils.h"
@@ -75,6 +77,43 @@ const char LayerName[] = "ObjectTracker";
 
 typedef std::unordered_map<uint64_t, OBJTRACK_NODE *> object_map_type;
 
+// Hands out OBJTRACK_NODEs from fixed-size chunks and recycles freed ones, so tracking an object doesn't cost a heap allocation
+class ObjTrackNodePool {
+   public:
+    OBJTRACK_NODE *Allocate() {
+        if (free_nodes_.empty()) {
+            chunks_.emplace_back(new OBJTRACK_NODE[kChunkSize]);
+            OBJTRACK_NODE *chunk = chunks_.back().get();
+            for (size_t i = kChunkSize; i > 0; --i) {
+                free_nodes_.push_back(&chunk[i - 1]);
+            }
+        }
+        OBJTRACK_NODE *node = free_nodes_.back();
+        free_nodes_.pop_back();
+        *node = OBJTRACK_NODE();
+        return node;
+    }
+    void Free(OBJTRACK_NODE *node) { free_nodes_.push_back(node); }
+
+   private:
+    static const size_t kChunkSize = 1024;
+    std::vector<std::unique_ptr<OBJTRACK_NODE[]>> chunks_;
+    std::vector<OBJTRACK_NODE *> free_nodes_;
+};
+
+// A tracked handle of a given type, regardless of which instance or device tracks it
+struct ObjTrackHandleKey {
+    uint64_t handle;
+    VulkanObjectType object_type;
+    bool operator==(const ObjTrackHandleKey &rhs) const { return handle == rhs.handle && object_type == rhs.object_type; }
+};
+
+struct ObjTrackHandleKeyHash {
+    size_t operator()(const ObjTrackHandleKey &key) const {
+        return std::hash<uint64_t>()(key.handle) ^ (static_cast<size_t>(key.object_type) * 0x9e3779b9u);
+    }
+};
+
 struct layer_data {
     VkInstance instance;
     VkPhysicalDevice physical_device;
@@ -116,11 +155,16 @@ struct layer_data {
     }
 };
 
-static std::unordered_map<void *, layer_data *> layer_data_map;
+static LayerDataMap<layer_data> layer_data_map;
 static device_table_map ot_device_table_map;
 static instance_table_map ot_instance_table_map;
 static std::mutex global_lock;
 static uint64_t object_track_index = 0;
+// Storage for every OBJTRACK_NODE held in any object map, guarded by global_lock
+static ObjTrackNodePool object_node_pool;
+// Number of object maps, across all instances and devices, holding each handle of each type, guarded by global_lock.
+// A handle missing from one device's maps is known to belong to another device after a single lookup here.
+static std::unordered_map<ObjTrackHandleKey, uint32_t, ObjTrackHandleKeyHash> object_owner_count;
 
 #include "vk_dispatch_table_helper.h"
 
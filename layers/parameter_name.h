@@ -19,36 +19,62 @@
 #define PARAMETER_NAME_H
 
 #include <cassert>
+#include <cstring>
+#include <initializer_list>
 #include <sstream>
 #include <string>
-#include <vector>
 
 /**
  * Parameter name string supporting deferred formatting for array subscripts.
  *
  * Custom parameter name class with support for deferred formatting of names containing array subscripts.  The class stores
- * a format string and a vector of index values, and performs string formatting when an accessor function is called to
- * retrieve the name string.  This class was primarily designed to be used with validation functions that receive a parameter name
- * string and value as arguments, and print an error message that includes the parameter name when the value fails a validation
- * test.  Using standard strings with these validation functions requires that parameter names containing array subscripts be
- * formatted before each validation function is called, performing the string formatting even when the value passes validation
- * and the string is not used:
+ * a pointer to a format string and a small inline array of index values, and performs string formatting when an accessor
+ * function is called to retrieve the name string.  This class was primarily designed to be used with validation functions that
+ * receive a parameter name string and value as arguments, and print an error message that includes the parameter name when the
+ * value fails a validation test.  Using standard strings with these validation functions requires that parameter names
+ * containing array subscripts be formatted before each validation function is called, performing the string formatting even
+ * when the value passes validation and the string is not used:
  *         sprintf(name, "pCreateInfo[%d].sType", i);
  *         validate_stype(name, pCreateInfo[i].sType);
  *
- * With the ParameterName class, a format string and a vector of format values are stored by the ParameterName object that is
+ * With the ParameterName class, a format string and the format values are stored by the ParameterName object that is
  * provided to the validation function.  String formatting is then performed only when the validation function retrieves the
  * name string from the ParameterName object:
  *         validate_stype(ParameterName("pCreateInfo[%i].sType", IndexVector{ i }), pCreateInfo[i].sType);
+ *
+ * Constructing a ParameterName does not allocate, so the objects built for every validated member cost nothing when the
+ * member passes validation.  The format string is not copied and must outlive the ParameterName object; the validation code
+ * only ever passes string literals.
  */
 class ParameterName {
    public:
-    /// Container for index values to be used with parameter name string formatting.
-    typedef std::vector<size_t> IndexVector;
+    /// Container for index values to be used with parameter name string formatting, stored inline.
+    class IndexVector {
+       public:
+        /// Maximum number of array subscripts in a single parameter name.
+        static const size_t kMaxSize = 4;
+
+        IndexVector(std::initializer_list<size_t> args) : size_(0) {
+            assert(args.size() <= kMaxSize);
+            for (size_t index : args) {
+                if (size_ == kMaxSize) break;
+                values_[size_++] = index;
+            }
+        }
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const size_t *begin() const { return values_; }
+        const size_t *end() const { return values_ + size_; }
+
+       private:
+        size_t values_[kMaxSize];
+        size_t size_;
+    };
 
     /// Format specifier for the parameter name string, to be replaced by an index value.  The parameter name string must contain
     /// one format specifier for each index value specified.
-    const std::string IndexFormatSpecifier = "%i";
+    static const char *IndexFormatSpecifier() { return "%i"; }
 
    public:
     /**
@@ -58,39 +84,10 @@ class ParameterName {
      *
      * @pre The source string must not contain the %i format specifier.
      */
-    ParameterName(const char *source) : source_(source) { assert(IsValid()); }
+    ParameterName(const char *source) : source_(source), args_({}) { assert(IsValid()); }
 
     /**
-    * Construct a ParameterName object from a std::string object, without formatting.
-    *
-    * @param source Paramater name string without format specifiers.
-    *
-    * @pre The source string must not contain the %i format specifier.
-    */
-    ParameterName(const std::string &source) : source_(source) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, without formatting.
-    *
-    * @param source Paramater name string without format specifiers.
-    *
-    * @pre The source string must not contain the %i format specifier.
-    */
-    ParameterName(const std::string &&source) : source_(std::move(source)) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, with formatting.
-    *
-    * @param source Paramater name string with format specifiers.
-    * @param args Array index values to be used for formatting.
-    *
-    * @pre The number of %i format specifiers contained by the source string must match the number of elements contained
-    *      by the index vector.
-    */
-    ParameterName(const std::string &source, const IndexVector &args) : source_(source), args_(args) { assert(IsValid()); }
-
-    /**
-    * Construct a ParameterName object from a std::string object, with formatting.
+    * Construct a ParameterName object from a string literal, with formatting.
     *
     * @param source Paramater name string with format specifiers.
     * @param args Array index values to be used for formatting.
@@ -98,50 +95,49 @@ class ParameterName {
     * @pre The number of %i format specifiers contained by the source string must match the number of elements contained
     *      by the index vector.
     */
-    ParameterName(const std::string &&source, const IndexVector &&args) : source_(std::move(source)), args_(std::move(args)) {
-        assert(IsValid());
-    }
+    ParameterName(const char *source, const IndexVector &args) : source_(source), args_(args) { assert(IsValid()); }
 
     /// Retrive the formatted name string.
-    std::string get_name() const { return (args_.empty()) ? source_ : Format(); }
+    std::string get_name() const { return (args_.empty()) ? std::string(source_) : Format(); }
 
    private:
     /// Replace the %i format specifiers in the source string with the values from the index vector.
     std::string Format() const {
-        std::string::size_type current = 0;
-        std::string::size_type last = 0;
+        const size_t specifier_length = strlen(IndexFormatSpecifier());
+        const char *last = source_;
         std::stringstream format;
 
         for (size_t index : args_) {
-            current = source_.find(IndexFormatSpecifier, last);
-            if (current == std::string::npos) {
+            const char *current = strstr(last, IndexFormatSpecifier());
+            if (current == nullptr) {
                 break;
             }
-            format << source_.substr(last, (current - last)) << index;
-            last = current + IndexFormatSpecifier.length();
+            format.write(last, current - last);
+            format << index;
+            last = current + specifier_length;
         }
 
-        format << source_.substr(last, std::string::npos);
+        format << last;
 
         return format.str();
     }
 
     /// Check that the number of %i format specifiers in the source string matches the number of elements in the index vector.
-    bool IsValid() {
+    bool IsValid() const {
         // Count the number of occurances of the format specifier
-        uint32_t count = 0;
-        std::string::size_type pos = source_.find(IndexFormatSpecifier);
+        size_t count = 0;
+        const char *pos = strstr(source_, IndexFormatSpecifier());
 
-        while (pos != std::string::npos) {
+        while (pos != nullptr) {
             ++count;
-            pos = source_.find(IndexFormatSpecifier, pos + 1);
+            pos = strstr(pos + 1, IndexFormatSpecifier());
         }
 
         return (count == args_.size());
     }
 
    private:
-    std::string source_;  ///< Format string.
+    const char *source_;  ///< Format string.
     IndexVector args_;    ///< Array index values for formatting.
 };
 
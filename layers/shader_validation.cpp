@@ -18,12 +18,18 @@
  * Author: Chris Forbes <chrisf@ijw.co.nz>
  */
 
+#include <algorithm>
 #include <cinttypes>
 #include <cassert>
 #include <vector>
 #include <unordered_map>
 #include <string>
 #include <sstream>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 #include <SPIRV/spirv.hpp>
 #include "vk_loader_platform.h"
 #include "vk_enum_string_helper.h"
@@ -67,8 +73,31 @@ static shader_stage_attributes shader_stage_attribs[] = {
 
 // SPIRV utility functions
 void shader_module::build_def_index() {
+    // Ids are bounded by the header's id bound. Every id needs an instruction of at least two words to define it, so a
+    // bound beyond the size of the module is bogus and ids are kept in def_map instead of a table of that size.
+    if (words.size() > 3) id_bound = words[3];
+    if (id_bound <= words.size()) {
+        def_index.resize(id_bound, 0);
+    }
     for (auto insn : *this) {
         switch (insn.opcode()) {
+            // Instructions looked up by opcode rather than by id
+            case spv::OpDecorate:
+                decorations.push_back(insn.offset());
+                break;
+
+            case spv::OpMemberDecorate:
+                member_decorations.push_back(insn.offset());
+                break;
+
+            case spv::OpEntryPoint:
+                entry_points.push_back(insn.offset());
+                break;
+
+            case spv::OpCapability:
+                capabilities.push_back(insn.offset());
+                break;
+
             // Types
             case spv::OpTypeVoid:
             case spv::OpTypeBool:
@@ -90,7 +119,7 @@ void shader_module::build_def_index() {
             case spv::OpTypeReserveId:
             case spv::OpTypeQueue:
             case spv::OpTypePipe:
-                def_index[insn.word(1)] = insn.offset();
+                add_def(insn.word(1), insn.offset());
                 break;
 
                 // Fixed constants
@@ -100,7 +129,7 @@ void shader_module::build_def_index() {
             case spv::OpConstantComposite:
             case spv::OpConstantSampler:
             case spv::OpConstantNull:
-                def_index[insn.word(2)] = insn.offset();
+                add_def(insn.word(2), insn.offset());
                 break;
 
                 // Specialization constants
@@ -109,17 +138,17 @@ void shader_module::build_def_index() {
             case spv::OpSpecConstant:
             case spv::OpSpecConstantComposite:
             case spv::OpSpecConstantOp:
-                def_index[insn.word(2)] = insn.offset();
+                add_def(insn.word(2), insn.offset());
                 break;
 
                 // Variables
             case spv::OpVariable:
-                def_index[insn.word(2)] = insn.offset();
+                add_def(insn.word(2), insn.offset());
                 break;
 
                 // Functions
             case spv::OpFunction:
-                def_index[insn.word(2)] = insn.offset();
+                add_def(insn.word(2), insn.offset());
                 break;
 
             default:
@@ -130,14 +159,13 @@ void shader_module::build_def_index() {
 }
 
 static spirv_inst_iter find_entrypoint(shader_module const *src, char const *name, VkShaderStageFlagBits stageBits) {
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpEntryPoint) {
-            auto entrypointName = (char const *)&insn.word(3);
-            auto entrypointStageBits = 1u << insn.word(1);
+    for (auto insn_offset : src->entry_points) {
+        auto insn = src->at(insn_offset);
+        auto entrypointName = (char const *)&insn.word(3);
+        auto entrypointStageBits = 1u << insn.word(1);
 
-            if (!strcmp(entrypointName, name) && (entrypointStageBits & stageBits)) {
-                return insn;
-            }
+        if (!strcmp(entrypointName, name) && (entrypointStageBits & stageBits)) {
+            return insn;
         }
     }
 
@@ -470,8 +498,9 @@ static bool collect_interface_block_members(shader_module const *src, std::map<l
     std::unordered_map<unsigned, unsigned> member_patch;
 
     // Walk all the OpMemberDecorate for type's result id -- first pass, collect components.
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpMemberDecorate && insn.word(1) == type.word(1)) {
+    for (auto insn_offset : src->member_decorations) {
+        auto insn = src->at(insn_offset);
+        if (insn.word(1) == type.word(1)) {
             unsigned member_index = insn.word(2);
 
             if (insn.word(3) == spv::DecorationComponent) {
@@ -492,8 +521,9 @@ static bool collect_interface_block_members(shader_module const *src, std::map<l
     // TODO: correctly handle location assignment from outside
 
     // Second pass -- produce the output, from Location decorations
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpMemberDecorate && insn.word(1) == type.word(1)) {
+    for (auto insn_offset : src->member_decorations) {
+        auto insn = src->at(insn_offset);
+        if (insn.word(1) == type.word(1)) {
             unsigned member_index = insn.word(2);
             unsigned member_type_id = type.word(2 + member_index);
 
@@ -532,33 +562,32 @@ static std::map<location_t, interface_var> collect_interface_by_location(shader_
     std::unordered_map<unsigned, unsigned> var_patch;
     std::unordered_map<unsigned, unsigned> var_relaxed_precision;
 
-    for (auto insn : *src) {
+    for (auto insn_offset : src->decorations) {
+        auto insn = src->at(insn_offset);
         // We consider two interface models: SSO rendezvous-by-location, and builtins. Complain about anything that
         // fits neither model.
-        if (insn.opcode() == spv::OpDecorate) {
-            if (insn.word(2) == spv::DecorationLocation) {
-                var_locations[insn.word(1)] = insn.word(3);
-            }
+        if (insn.word(2) == spv::DecorationLocation) {
+            var_locations[insn.word(1)] = insn.word(3);
+        }
 
-            if (insn.word(2) == spv::DecorationBuiltIn) {
-                var_builtins[insn.word(1)] = insn.word(3);
-            }
+        if (insn.word(2) == spv::DecorationBuiltIn) {
+            var_builtins[insn.word(1)] = insn.word(3);
+        }
 
-            if (insn.word(2) == spv::DecorationComponent) {
-                var_components[insn.word(1)] = insn.word(3);
-            }
+        if (insn.word(2) == spv::DecorationComponent) {
+            var_components[insn.word(1)] = insn.word(3);
+        }
 
-            if (insn.word(2) == spv::DecorationBlock) {
-                blocks[insn.word(1)] = 1;
-            }
+        if (insn.word(2) == spv::DecorationBlock) {
+            blocks[insn.word(1)] = 1;
+        }
 
-            if (insn.word(2) == spv::DecorationPatch) {
-                var_patch[insn.word(1)] = 1;
-            }
+        if (insn.word(2) == spv::DecorationPatch) {
+            var_patch[insn.word(1)] = 1;
+        }
 
-            if (insn.word(2) == spv::DecorationRelaxedPrecision) {
-                var_relaxed_precision[insn.word(1)] = 1;
-            }
+        if (insn.word(2) == spv::DecorationRelaxedPrecision) {
+            var_relaxed_precision[insn.word(1)] = 1;
         }
     }
 
@@ -615,25 +644,24 @@ static std::vector<std::pair<uint32_t, interface_var>> collect_interface_by_inpu
     shader_module const *src, std::unordered_set<uint32_t> const &accessible_ids) {
     std::vector<std::pair<uint32_t, interface_var>> out;
 
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpDecorate) {
-            if (insn.word(2) == spv::DecorationInputAttachmentIndex) {
-                auto attachment_index = insn.word(3);
-                auto id = insn.word(1);
-
-                if (accessible_ids.count(id)) {
-                    auto def = src->get_def(id);
-                    assert(def != src->end());
-
-                    if (def.opcode() == spv::OpVariable && insn.word(3) == spv::StorageClassUniformConstant) {
-                        auto num_locations = get_locations_consumed_by_type(src, def.word(1), false);
-                        for (unsigned int offset = 0; offset < num_locations; offset++) {
-                            interface_var v = {};
-                            v.id = id;
-                            v.type_id = def.word(1);
-                            v.offset = offset;
-                            out.emplace_back(attachment_index + offset, v);
-                        }
+    for (auto insn_offset : src->decorations) {
+        auto insn = src->at(insn_offset);
+        if (insn.word(2) == spv::DecorationInputAttachmentIndex) {
+            auto attachment_index = insn.word(3);
+            auto id = insn.word(1);
+
+            if (accessible_ids.count(id)) {
+                auto def = src->get_def(id);
+                assert(def != src->end());
+
+                if (def.opcode() == spv::OpVariable && insn.word(3) == spv::StorageClassUniformConstant) {
+                    auto num_locations = get_locations_consumed_by_type(src, def.word(1), false);
+                    for (unsigned int offset = 0; offset < num_locations; offset++) {
+                        interface_var v = {};
+                        v.id = id;
+                        v.type_id = def.word(1);
+                        v.offset = offset;
+                        out.emplace_back(attachment_index + offset, v);
                     }
                 }
             }
@@ -648,17 +676,16 @@ static std::vector<std::pair<descriptor_slot_t, interface_var>> collect_interfac
     std::unordered_map<unsigned, unsigned> var_sets;
     std::unordered_map<unsigned, unsigned> var_bindings;
 
-    for (auto insn : *src) {
+    for (auto insn_offset : src->decorations) {
+        auto insn = src->at(insn_offset);
         // All variables in the Uniform or UniformConstant storage classes are required to be decorated with both
         // DecorationDescriptorSet and DecorationBinding.
-        if (insn.opcode() == spv::OpDecorate) {
-            if (insn.word(2) == spv::DecorationDescriptorSet) {
-                var_sets[insn.word(1)] = insn.word(3);
-            }
+        if (insn.word(2) == spv::DecorationDescriptorSet) {
+            var_sets[insn.word(1)] = insn.word(3);
+        }
 
-            if (insn.word(2) == spv::DecorationBinding) {
-                var_bindings[insn.word(1)] = insn.word(3);
-            }
+        if (insn.word(2) == spv::DecorationBinding) {
+            var_bindings[insn.word(1)] = insn.word(3);
         }
     }
 
@@ -955,8 +982,9 @@ static bool validate_push_constant_block_against_pipeline(debug_report_data cons
 
     // Validate directly off the offsets. this isn't quite correct for arrays and matrices, but is a good first step.
     // TODO: arrays, matrices, weird sizes
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpMemberDecorate && insn.word(1) == type.word(1)) {
+    for (auto insn_offset : src->member_decorations) {
+        auto insn = src->at(insn_offset);
+        if (insn.word(1) == type.word(1)) {
             if (insn.word(3) == spv::DecorationOffset) {
                 unsigned offset = insn.word(4);
                 auto size = 4;  // Bytes; TODO: calculate this based on the type
@@ -1051,8 +1079,9 @@ static bool descriptor_type_match(shader_module const *module, uint32_t type_id,
 
     switch (type.opcode()) {
         case spv::OpTypeStruct: {
-            for (auto insn : *module) {
-                if (insn.opcode() == spv::OpDecorate && insn.word(1) == type.word(1)) {
+            for (auto insn_offset : module->decorations) {
+                auto insn = module->at(insn_offset);
+                if (insn.word(1) == type.word(1)) {
                     if (insn.word(2) == spv::DecorationBlock) {
                         return descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
                             descriptor_type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -1205,16 +1234,15 @@ static bool validate_shader_capabilities(layer_data *dev_data, shader_module con
     };
     // clang-format on
 
-    for (auto insn : *src) {
-        if (insn.opcode() == spv::OpCapability) {
-            auto it = capabilities.find(insn.word(1));
-            if (it != capabilities.end()) {
-                if (it->second.feature) {
-                    skip |= require_feature(report_data, enabledFeatures->*(it->second.feature), it->second.name);
-                }
-                if (it->second.extension) {
-                    skip |= require_extension(report_data, extensions->*(it->second.extension), it->second.name);
-                }
+    for (auto insn_offset : src->capabilities) {
+        auto insn = src->at(insn_offset);
+        auto it = capabilities.find(insn.word(1));
+        if (it != capabilities.end()) {
+            if (it->second.feature) {
+                skip |= require_feature(report_data, enabledFeatures->*(it->second.feature), it->second.name);
+            }
+            if (it->second.extension) {
+                skip |= require_extension(report_data, extensions->*(it->second.extension), it->second.name);
             }
         }
     }
@@ -1510,6 +1538,216 @@ bool validate_compute_pipeline(layer_data *dev_data, PIPELINE_STATE *pPipeline)
     return validate_pipeline_shader_stage(dev_data, &pCreateInfo->stage, pPipeline, &module, &entrypoint);
 }
 
+// Layout of the cache file: a header of kSpirvCacheFileMagic, kSpirvCacheFileVersion and the SPIRV-Tools version string,
+// followed by one record per module of {SHA-256 digest of the code, spv_result_t, diagnostic length, diagnostic text},
+// least recently used first. A file written by a different SPIRV-Tools is ignored, since a newer validator may judge the
+// same module differently. A file that is truncated or whose lengths run past its end is ignored as a whole. Only the
+// kSpirvCacheMaxEntries most recently used results are written back, so the file can't grow without bound.
+static const uint32_t kSpirvCacheFileMagic = 0x56565053;  // "SPVV"
+static const uint32_t kSpirvCacheFileVersion = 3;
+static const size_t kSpirvCacheMaxEntries = 65536;
+
+// SHA-256 (FIPS 180-4) of a SPIR-V module's code. A 64-bit hash would make a collision between two different modules,
+// which would hand one module the other's validation result, likely enough to matter across a persistent cache.
+static std::array<uint32_t, 8> hash_spirv(uint32_t const *code, size_t word_count) {
+    static const uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01,
+        0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+        0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+        0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116, 0x1e376c08,
+        0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+        0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    std::array<uint32_t, 8> h = {{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}};
+    auto rotr = [](uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); };
+
+    auto bytes = reinterpret_cast<uint8_t const *>(code);
+    uint64_t size = static_cast<uint64_t>(word_count) * sizeof(uint32_t);
+    // The message is followed by 0x80, zero padding and its length in bits, to a multiple of 64 bytes
+    uint64_t padded_size = (size + 9 + 63) & ~63ull;
+    for (uint64_t block = 0; block < padded_size; block += 64) {
+        uint32_t w[64];
+        for (uint32_t i = 0; i < 16; ++i) {
+            uint32_t word = 0;
+            for (uint32_t j = 0; j < 4; ++j) {
+                uint64_t index = block + i * 4 + j;
+                uint8_t byte;
+                if (index < size) {
+                    byte = bytes[index];
+                } else if (index == size) {
+                    byte = 0x80;
+                } else if (index >= padded_size - 8) {
+                    byte = static_cast<uint8_t>((size * 8) >> (8 * (padded_size - 1 - index)));
+                } else {
+                    byte = 0;
+                }
+                word = (word << 8) | byte;
+            }
+            w[i] = word;
+        }
+        for (uint32_t i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (uint32_t i = 0; i < 64; ++i) {
+            uint32_t t1 = hh + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+        h[5] += f;
+        h[6] += g;
+        h[7] += hh;
+    }
+    return h;
+}
+
+// Lengths read from the file are checked against the bytes left in it before anything is allocated for them
+static uint64_t bytes_left(FILE *file, uint64_t file_size) {
+    long position = ftell(file);
+    return (position < 0 || static_cast<uint64_t>(position) > file_size) ? 0 : file_size - static_cast<uint64_t>(position);
+}
+static bool read_u32(FILE *file, uint32_t *value) { return fread(value, sizeof(*value), 1, file) == 1; }
+static bool read_string(FILE *file, uint64_t file_size, std::string *value) {
+    uint32_t length;
+    if (!read_u32(file, &length) || length > bytes_left(file, file_size)) return false;
+    value->resize(length);
+    return length == 0 || fread(&(*value)[0], 1, length, file) == length;
+}
+static bool write_u32(FILE *file, uint32_t value) { return fwrite(&value, sizeof(value), 1, file) == 1; }
+static bool write_string(FILE *file, std::string const &value) {
+    return write_u32(file, static_cast<uint32_t>(value.size())) && fwrite(value.data(), 1, value.size(), file) == value.size();
+}
+
+spirv_validation_cache::spirv_validation_cache(const char *cache_filename)
+    : context(spvContextCreate(SPV_ENV_VULKAN_1_0)), filename(cache_filename ? cache_filename : ""), use_count(0), dirty(false) {
+    load();
+}
+
+spirv_validation_cache::~spirv_validation_cache() {
+    if (dirty) save();
+    spvContextDestroy(context);
+}
+
+spv_result_t spirv_validation_cache::validate(uint32_t const *code, size_t word_count, std::string *diagnostic) {
+    auto hash = hash_spirv(code, word_count);
+    {
+        std::lock_guard<std::mutex> guard(results_lock);
+        auto it = results.find(hash);
+        if (it != results.end()) {
+            it->second.last_used = ++use_count;
+            dirty = true;
+            *diagnostic = it->second.diagnostic;
+            return it->second.result;
+        }
+    }
+
+    // Validate without holding the lock so that modules created on different threads are validated in parallel;
+    // spvValidate doesn't modify the context.
+    spv_const_binary_t binary{code, word_count};
+    spv_diagnostic diag = nullptr;
+    cached_result result = {spvValidate(context, &binary, &diag), "", 0};
+    if (result.result != SPV_SUCCESS) {
+        result.diagnostic = diag && diag->error ? diag->error : "(no error text)";
+    }
+    spvDiagnosticDestroy(diag);
+    *diagnostic = result.diagnostic;
+
+    std::lock_guard<std::mutex> guard(results_lock);
+    result.last_used = ++use_count;
+    results[hash] = result;
+    dirty = true;
+    return result.result;
+}
+
+void spirv_validation_cache::load() {
+    if (filename.empty()) return;
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (!file) return;
+
+    uint64_t file_size = 0;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        long end = ftell(file);
+        if (end > 0) file_size = static_cast<uint64_t>(end);
+    }
+    fseek(file, 0, SEEK_SET);
+
+    uint32_t magic, version;
+    std::string tools_version;
+    if (read_u32(file, &magic) && magic == kSpirvCacheFileMagic && read_u32(file, &version) && version == kSpirvCacheFileVersion &&
+        read_string(file, file_size, &tools_version) && tools_version == spvSoftwareVersionString()) {
+        digest hash;
+        cached_result result;
+        uint32_t spv_result;
+        while (bytes_left(file, file_size) > 0) {
+            if (fread(hash.data(), sizeof(uint32_t), hash.size(), file) != hash.size() || !read_u32(file, &spv_result) ||
+                !read_string(file, file_size, &result.diagnostic)) {
+                results.clear();
+                break;
+            }
+            result.result = static_cast<spv_result_t>(static_cast<int32_t>(spv_result));
+            // Records are stored least recently used first, so reading them in order restores their relative age
+            result.last_used = ++use_count;
+            results[hash] = result;
+        }
+    }
+    fclose(file);
+}
+
+void spirv_validation_cache::save() const {
+    if (filename.empty()) return;
+
+    // Keep the most recently used results, written oldest first
+    typedef std::pair<uint64_t, std::unordered_map<digest, cached_result, digest_hash>::const_iterator> entry_by_age;
+    std::vector<entry_by_age> entries;
+    entries.reserve(results.size());
+    for (auto it = results.begin(); it != results.end(); ++it) {
+        entries.emplace_back(it->second.last_used, it);
+    }
+    std::sort(entries.begin(), entries.end(), [](entry_by_age const &a, entry_by_age const &b) { return a.first < b.first; });
+    size_t first_entry = entries.size() > kSpirvCacheMaxEntries ? entries.size() - kSpirvCacheMaxEntries : 0;
+
+    // Write a temporary file next to the cache and rename it over the cache, so that an interrupted save or another
+    // process saving at the same time never leaves a partial file behind
+#ifdef _WIN32
+    std::string temp_filename = filename + ".tmp" + std::to_string(_getpid());
+#else
+    std::string temp_filename = filename + ".tmp" + std::to_string(getpid());
+#endif
+    FILE *file = fopen(temp_filename.c_str(), "wb");
+    if (!file) return;
+
+    bool written = write_u32(file, kSpirvCacheFileMagic) && write_u32(file, kSpirvCacheFileVersion) &&
+                   write_string(file, spvSoftwareVersionString());
+    for (size_t i = first_entry; written && i < entries.size(); ++i) {
+        auto const &entry = *entries[i].second;
+        written = fwrite(entry.first.data(), sizeof(uint32_t), entry.first.size(), file) == entry.first.size() &&
+                  write_u32(file, static_cast<uint32_t>(static_cast<int32_t>(entry.second.result))) &&
+                  write_string(file, entry.second.diagnostic);
+    }
+    written = (fclose(file) == 0) && written;
+
+#ifdef _WIN32
+    written = written && MoveFileExA(temp_filename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    written = written && rename(temp_filename.c_str(), filename.c_str()) == 0;
+#endif
+    if (!written) remove(temp_filename.c_str());
+}
+
 bool PreCallValidateCreateShaderModule(layer_data *dev_data, VkShaderModuleCreateInfo const *pCreateInfo, bool *spirv_valid) {
     bool skip = false;
     spv_result_t spv_valid = SPV_SUCCESS;
@@ -1528,22 +1766,17 @@ bool PreCallValidateCreateShaderModule(layer_data *dev_data, VkShaderModuleCreat
                         pCreateInfo->codeSize, validation_error_map[VALIDATION_ERROR_12a00ac0]);
     } else {
         // Use SPIRV-Tools validator to try and catch any issues with the module itself
-        spv_context ctx = spvContextCreate(SPV_ENV_VULKAN_1_0);
-        spv_const_binary_t binary{ pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t) };
-        spv_diagnostic diag = nullptr;
-
-        spv_valid = spvValidate(ctx, &binary, &diag);
+        std::string diagnostic;
+        spv_valid = GetSpirvValidationCache(dev_data)->validate(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t),
+                                                                &diagnostic);
         if (spv_valid != SPV_SUCCESS) {
             if (!have_glsl_shader || (pCreateInfo->pCode[0] == spv::MagicNumber)) {
                 skip |= log_msg(report_data,
                                 spv_valid == SPV_WARNING ? VK_DEBUG_REPORT_WARNING_BIT_EXT : VK_DEBUG_REPORT_ERROR_BIT_EXT,
                                 VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT, 0, __LINE__, SHADER_CHECKER_INCONSISTENT_SPIRV, "SC",
-                                "SPIR-V module not valid: %s", diag && diag->error ? diag->error : "(no error text)");
+                                "SPIR-V module not valid: %s", diagnostic.c_str());
             }
         }
-
-        spvDiagnosticDestroy(diag);
-        spvContextDestroy(ctx);
     }
 
     *spirv_valid = (spv_valid == SPV_SUCCESS);
@@ -20,6 +20,13 @@
 #ifndef VULKAN_SHADER_VALIDATION_H
 #define VULKAN_SHADER_VALIDATION_H
 
+#include <array>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include "spirv-tools/libspirv.h"
+
 // A forward iterator over spirv instructions. Provides easy access to len, opcode, and content words
 // without the caller needing to care too much about the physical SPIRV module layout.
 struct spirv_inst_iter {
@@ -68,19 +75,31 @@ struct spirv_inst_iter {
 struct shader_module {
     // The spirv image itself
     std::vector<uint32_t> words;
-    // A mapping of <id> to the first word of its def. this is useful because walking type
-    // trees, constant expressions, etc requires jumping all over the instruction stream.
-    std::unordered_map<unsigned, unsigned> def_index;
+    // A mapping of <id> to the first word of its def, indexed by id. this is useful because walking type
+    // trees, constant expressions, etc requires jumping all over the instruction stream. SPIR-V ids are dense,
+    // so a flat table beats hashing; 0 (inside the module header) marks ids without a def we track.
+    std::vector<unsigned> def_index;
+    // Used instead of def_index when the header's id bound is larger than the module could possibly need
+    std::unordered_map<unsigned, unsigned> def_map;
+    // Id bound from the module header; defs of ids at or past it are ignored
+    unsigned id_bound;
+    // Offsets of the instructions validation searches repeatedly, collected once by build_def_index() so that
+    // lookups don't walk the whole instruction stream.
+    std::vector<unsigned> decorations;         // OpDecorate
+    std::vector<unsigned> member_decorations;  // OpMemberDecorate
+    std::vector<unsigned> entry_points;        // OpEntryPoint
+    std::vector<unsigned> capabilities;        // OpCapability
     bool has_valid_spirv;
 
     shader_module(VkShaderModuleCreateInfo const *pCreateInfo)
         : words((uint32_t *)pCreateInfo->pCode, (uint32_t *)pCreateInfo->pCode + pCreateInfo->codeSize / sizeof(uint32_t)),
           def_index(),
+          id_bound(0),
           has_valid_spirv(true) {
         build_def_index();
     }
 
-    shader_module() : has_valid_spirv(false) {}
+    shader_module() : id_bound(0), has_valid_spirv(false) {}
 
     // Expose begin() / end() to enable range-based for
     spirv_inst_iter begin() const { return spirv_inst_iter(words.begin(), words.begin() + 5); }  // First insn
@@ -90,19 +109,68 @@ struct shader_module {
 
     // Gets an iterator to the definition of an id
     spirv_inst_iter get_def(unsigned id) const {
-        auto it = def_index.find(id);
-        if (it == def_index.end()) {
+        if (!def_map.empty()) {
+            auto it = def_map.find(id);
+            return it == def_map.end() ? end() : at(it->second);
+        }
+        if (id >= def_index.size() || !def_index[id]) {
             return end();
         }
-        return at(it->second);
+        return at(def_index[id]);
     }
 
     void build_def_index();
+
+   private:
+    void add_def(unsigned id, unsigned offset) {
+        if (id >= id_bound) return;
+        if (def_index.empty()) {
+            def_map[id] = offset;
+        } else {
+            def_index[id] = offset;
+        }
+    }
+};
+
+// SPIRV-Tools validation results for shader modules, keyed on a SHA-256 digest of the module's code, so that identical
+// modules are validated only once per device. All validations share one spv_context. If a cache file is given, results
+// are loaded from it on creation and written back on destruction, so identical modules are also skipped across runs.
+class spirv_validation_cache {
+   public:
+    explicit spirv_validation_cache(const char *cache_filename);
+    ~spirv_validation_cache();
+
+    // Validate code, or return the result of an earlier validation of identical code. On failure the diagnostic text is
+    // written to *diagnostic.
+    spv_result_t validate(uint32_t const *code, size_t word_count, std::string *diagnostic);
+
+   private:
+    typedef std::array<uint32_t, 8> digest;
+    struct digest_hash {
+        // The digest is already uniformly distributed, so any word of it makes a good hash
+        size_t operator()(digest const &value) const { return value[0]; }
+    };
+    struct cached_result {
+        spv_result_t result;
+        std::string diagnostic;
+        uint64_t last_used;  // Value of use_count when the result was last looked up or stored
+    };
+
+    void load();
+    void save() const;
+
+    std::mutex results_lock;
+    spv_context context;
+    std::string filename;
+    std::unordered_map<digest, cached_result, digest_hash> results;
+    uint64_t use_count;
+    bool dirty;
 };
 
 bool validate_and_capture_pipeline_shader_state(layer_data *dev_data, PIPELINE_STATE *pPipeline);
 bool validate_compute_pipeline(layer_data *dev_data, PIPELINE_STATE *pPipeline);
 typedef std::pair<unsigned, unsigned> descriptor_slot_t;
 bool PreCallValidateCreateShaderModule(layer_data *dev_data, VkShaderModuleCreateInfo const *pCreateInfo, bool *spirv_valid);
+spirv_validation_cache *GetSpirvValidationCache(layer_data *dev_data);
 
 #endif //VULKAN_SHADER_VALIDATION_H
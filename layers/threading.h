@@ -68,29 +68,43 @@ inline bool startMultiThread() {
 inline void finishMultiThread() { vulkan_in_use = false; }
 }  // namespace threading
 
+// Number of independently locked shards in each object use table. Uses of different objects usually land in different
+// shards, so threads working on separate objects rarely wait on the same lock or get woken for each other's objects.
+static const size_t kThreadingShardCount = 16;
+
+// Pick the shard for a handle. Handle values are pointers or driver ids whose low bits are often constant, so mix them first.
+template <typename T>
+inline size_t threadingShardIndex(T object) {
+    uint64_t value = (uint64_t)(object);
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return static_cast<size_t>(value % kThreadingShardCount);
+}
+
 template <typename T>
 class counter {
    public:
     const char *typeName;
     VkDebugReportObjectTypeEXT objectType;
-    std::unordered_map<T, object_use_data> uses;
-    std::mutex counter_lock;
-    std::condition_variable counter_condition;
+
     void startWrite(debug_report_data *report_data, T object) {
         if (object == VK_NULL_HANDLE) {
             return;
         }
         bool skipCall = false;
         loader_platform_thread_id tid = loader_platform_get_thread_id();
-        std::unique_lock<std::mutex> lock(counter_lock);
-        if (uses.find(object) == uses.end()) {
+        counter_shard &shard = getShard(object);
+        std::unique_lock<std::mutex> lock(shard.counter_lock);
+        auto use = shard.uses.find(object);
+        if (use == shard.uses.end()) {
             // There is no current use of the object.  Record writer thread.
-            struct object_use_data *use_data = &uses[object];
+            struct object_use_data *use_data = &shard.uses[object];
             use_data->reader_count = 0;
             use_data->writer_count = 1;
             use_data->thread = tid;
         } else {
-            struct object_use_data *use_data = &uses[object];
+            struct object_use_data *use_data = &use->second;
             if (use_data->reader_count == 0) {
                 // There are no readers.  Two writers just collided.
                 if (use_data->thread != tid) {
@@ -100,11 +114,11 @@ class counter {
                                         typeName, use_data->thread, tid);
                     if (skipCall) {
                         // Wait for thread-safe access to object instead of skipping call.
-                        while (uses.find(object) != uses.end()) {
-                            counter_condition.wait(lock);
+                        while (shard.uses.find(object) != shard.uses.end()) {
+                            shard.counter_condition.wait(lock);
                         }
                         // There is now no current use of the object.  Record writer thread.
-                        struct object_use_data *new_use_data = &uses[object];
+                        struct object_use_data *new_use_data = &shard.uses[object];
                         new_use_data->thread = tid;
                         new_use_data->reader_count = 0;
                         new_use_data->writer_count = 1;
@@ -127,11 +141,11 @@ class counter {
                                         typeName, use_data->thread, tid);
                     if (skipCall) {
                         // Wait for thread-safe access to object instead of skipping call.
-                        while (uses.find(object) != uses.end()) {
-                            counter_condition.wait(lock);
+                        while (shard.uses.find(object) != shard.uses.end()) {
+                            shard.counter_condition.wait(lock);
                         }
                         // There is now no current use of the object.  Record writer thread.
-                        struct object_use_data *new_use_data = &uses[object];
+                        struct object_use_data *new_use_data = &shard.uses[object];
                         new_use_data->thread = tid;
                         new_use_data->reader_count = 0;
                         new_use_data->writer_count = 1;
@@ -154,14 +168,19 @@ class counter {
             return;
         }
         // Object is no longer in use
-        std::unique_lock<std::mutex> lock(counter_lock);
-        uses[object].writer_count -= 1;
-        if ((uses[object].reader_count == 0) && (uses[object].writer_count == 0)) {
-            uses.erase(object);
+        counter_shard &shard = getShard(object);
+        std::unique_lock<std::mutex> lock(shard.counter_lock);
+        auto use = shard.uses.find(object);
+        if (use == shard.uses.end()) {
+            return;
+        }
+        use->second.writer_count -= 1;
+        if ((use->second.reader_count == 0) && (use->second.writer_count == 0)) {
+            shard.uses.erase(use);
         }
         // Notify any waiting threads that this object may be safe to use
         lock.unlock();
-        counter_condition.notify_all();
+        shard.counter_condition.notify_all();
     }
 
     void startRead(debug_report_data *report_data, T object) {
@@ -170,54 +189,103 @@ class counter {
         }
         bool skipCall = false;
         loader_platform_thread_id tid = loader_platform_get_thread_id();
-        std::unique_lock<std::mutex> lock(counter_lock);
-        if (uses.find(object) == uses.end()) {
+        counter_shard &shard = getShard(object);
+        std::unique_lock<std::mutex> lock(shard.counter_lock);
+        auto use = shard.uses.find(object);
+        if (use == shard.uses.end()) {
             // There is no current use of the object.  Record reader count
-            struct object_use_data *use_data = &uses[object];
+            struct object_use_data *use_data = &shard.uses[object];
             use_data->reader_count = 1;
             use_data->writer_count = 0;
             use_data->thread = tid;
-        } else if (uses[object].writer_count > 0 && uses[object].thread != tid) {
+        } else if (use->second.writer_count > 0 && use->second.thread != tid) {
             // There is a writer of the object.
             skipCall |= log_msg(report_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, objectType, (uint64_t)(object), 0,
                                 THREADING_CHECKER_MULTIPLE_THREADS, "THREADING",
                                 "THREADING ERROR : object of type %s is simultaneously used in thread %ld and thread %ld", typeName,
-                                uses[object].thread, tid);
+                                use->second.thread, tid);
             if (skipCall) {
                 // Wait for thread-safe access to object instead of skipping call.
-                while (uses.find(object) != uses.end()) {
-                    counter_condition.wait(lock);
+                while (shard.uses.find(object) != shard.uses.end()) {
+                    shard.counter_condition.wait(lock);
                 }
                 // There is no current use of the object.  Record reader count
-                struct object_use_data *use_data = &uses[object];
+                struct object_use_data *use_data = &shard.uses[object];
                 use_data->reader_count = 1;
                 use_data->writer_count = 0;
                 use_data->thread = tid;
             } else {
-                uses[object].reader_count += 1;
+                use->second.reader_count += 1;
             }
         } else {
             // There are other readers of the object.  Increase reader count
-            uses[object].reader_count += 1;
+            use->second.reader_count += 1;
         }
     }
     void finishRead(T object) {
         if (object == VK_NULL_HANDLE) {
             return;
         }
-        std::unique_lock<std::mutex> lock(counter_lock);
-        uses[object].reader_count -= 1;
-        if ((uses[object].reader_count == 0) && (uses[object].writer_count == 0)) {
-            uses.erase(object);
+        counter_shard &shard = getShard(object);
+        std::unique_lock<std::mutex> lock(shard.counter_lock);
+        auto use = shard.uses.find(object);
+        if (use == shard.uses.end()) {
+            return;
+        }
+        use->second.reader_count -= 1;
+        if ((use->second.reader_count == 0) && (use->second.writer_count == 0)) {
+            shard.uses.erase(use);
         }
         // Notify any waiting threads that this object may be safe to use
         lock.unlock();
-        counter_condition.notify_all();
+        shard.counter_condition.notify_all();
     }
     counter(const char *name = "", VkDebugReportObjectTypeEXT type = VK_DEBUG_REPORT_OBJECT_TYPE_UNKNOWN_EXT) {
         typeName = name;
         objectType = type;
     }
+
+   private:
+    // One shard of the object use table, with its own lock and its own wakeups for threads waiting on its objects
+    struct counter_shard {
+        std::unordered_map<T, object_use_data> uses;
+        std::mutex counter_lock;
+        std::condition_variable counter_condition;
+    };
+    counter_shard shards[kThreadingShardCount];
+
+    counter_shard &getShard(T object) { return shards[threadingShardIndex(object)]; }
+};
+
+// Map from each command buffer to the pool it was allocated from, sharded like the object use counters so that threads
+// recording into different command buffers don't serialize on one lock to find the pool.
+class command_pool_table {
+   public:
+    VkCommandPool getPool(VkCommandBuffer command_buffer) {
+        pool_shard &shard = getShard(command_buffer);
+        std::lock_guard<std::mutex> lock(shard.pool_lock);
+        auto it = shard.pools.find(command_buffer);
+        return (it == shard.pools.end()) ? VK_NULL_HANDLE : it->second;
+    }
+    void setPool(VkCommandBuffer command_buffer, VkCommandPool pool) {
+        pool_shard &shard = getShard(command_buffer);
+        std::lock_guard<std::mutex> lock(shard.pool_lock);
+        shard.pools[command_buffer] = pool;
+    }
+    void erasePool(VkCommandBuffer command_buffer) {
+        pool_shard &shard = getShard(command_buffer);
+        std::lock_guard<std::mutex> lock(shard.pool_lock);
+        shard.pools.erase(command_buffer);
+    }
+
+   private:
+    struct pool_shard {
+        std::unordered_map<VkCommandBuffer, VkCommandPool> pools;
+        std::mutex pool_lock;
+    };
+    pool_shard shards[kThreadingShardCount];
+
+    pool_shard &getShard(VkCommandBuffer command_buffer) { return shards[threadingShardIndex(command_buffer)]; }
 };
 
 struct layer_data {
@@ -359,16 +427,13 @@ WRAPPER(VkDescriptorUpdateTemplateKHR)
 WRAPPER(uint64_t)
 #endif  // DISTINCT_NONDISPATCHABLE_HANDLES
 
-static std::unordered_map<void *, layer_data *> layer_data_map;
-static std::mutex command_pool_lock;
-static std::unordered_map<VkCommandBuffer, VkCommandPool> command_pool_map;
+static LayerDataMap<layer_data> layer_data_map;
+static command_pool_table command_pool_map;
 
 // VkCommandBuffer needs check for implicit use of command pool
 static void startWriteObject(struct layer_data *my_data, VkCommandBuffer object, bool lockPool = true) {
     if (lockPool) {
-        std::unique_lock<std::mutex> lock(command_pool_lock);
-        VkCommandPool pool = command_pool_map[object];
-        lock.unlock();
+        VkCommandPool pool = command_pool_map.getPool(object);
         startWriteObject(my_data, pool);
     }
     my_data->c_VkCommandBuffer.startWrite(my_data->report_data, object);
@@ -376,24 +441,18 @@ static void startWriteObject(struct layer_data *my_data, VkCommandBuffer object,
 static void finishWriteObject(struct layer_data *my_data, VkCommandBuffer object, bool lockPool = true) {
     my_data->c_VkCommandBuffer.finishWrite(object);
     if (lockPool) {
-        std::unique_lock<std::mutex> lock(command_pool_lock);
-        VkCommandPool pool = command_pool_map[object];
-        lock.unlock();
+        VkCommandPool pool = command_pool_map.getPool(object);
         finishWriteObject(my_data, pool);
     }
 }
 static void startReadObject(struct layer_data *my_data, VkCommandBuffer object) {
-    std::unique_lock<std::mutex> lock(command_pool_lock);
-    VkCommandPool pool = command_pool_map[object];
-    lock.unlock();
+    VkCommandPool pool = command_pool_map.getPool(object);
     startReadObject(my_data, pool);
     my_data->c_VkCommandBuffer.startRead(my_data->report_data, object);
 }
 static void finishReadObject(struct layer_data *my_data, VkCommandBuffer object) {
     my_data->c_VkCommandBuffer.finishRead(object);
-    std::unique_lock<std::mutex> lock(command_pool_lock);
-    VkCommandPool pool = command_pool_map[object];
-    lock.unlock();
+    VkCommandPool pool = command_pool_map.getPool(object);
     finishReadObject(my_data, pool);
 }
 #endif  // THREADING_H
@@ -283,12 +283,11 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateComputePipelines(VkDevice device, VkPipelin
                                                       const VkComputePipelineCreateInfo *pCreateInfos,
                                                       const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines) {
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    safe_VkComputePipelineCreateInfo *local_pCreateInfos = NULL;
+    ScratchScope scratch;
+    VkComputePipelineCreateInfo *local_pCreateInfos = NULL;
     if (pCreateInfos) {
-        std::lock_guard<std::mutex> lock(global_lock);
-        local_pCreateInfos = new safe_VkComputePipelineCreateInfo[createInfoCount];
+        local_pCreateInfos = scratch.Copy(pCreateInfos, createInfoCount);
         for (uint32_t idx0 = 0; idx0 < createInfoCount; ++idx0) {
-            local_pCreateInfos[idx0].initialize(&pCreateInfos[idx0]);
             if (pCreateInfos[idx0].basePipelineHandle) {
                 local_pCreateInfos[idx0].basePipelineHandle = Unwrap(device_data, pCreateInfos[idx0].basePipelineHandle);
             }
@@ -301,19 +300,19 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateComputePipelines(VkDevice device, VkPipelin
         }
     }
     if (pipelineCache) {
-        std::lock_guard<std::mutex> lock(global_lock);
         pipelineCache = Unwrap(device_data, pipelineCache);
     }
 
-    VkResult result = device_data->dispatch_table.CreateComputePipelines(
-        device, pipelineCache, createInfoCount, local_pCreateInfos->ptr(), pAllocator, pPipelines);
-    delete[] local_pCreateInfos;
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        for (uint32_t i = 0; i < createInfoCount; ++i) {
-            if (pPipelines[i] != VK_NULL_HANDLE) {
-                pPipelines[i] = WrapNew(device_data, pPipelines[i]);
+    VkResult result = device_data->dispatch_table.CreateComputePipelines(device, pipelineCache, createInfoCount,
+                                                                         local_pCreateInfos, pAllocator, pPipelines);
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        if (pPipelines[i] != VK_NULL_HANDLE) {
+            VkPipeline wrapped_pipeline = WrapNew(device_data, pPipelines[i]);
+            if (wrapped_pipeline == VK_NULL_HANDLE) {
+                device_data->dispatch_table.DestroyPipeline(device, pPipelines[i], pAllocator);
+                result = VK_ERROR_OUT_OF_HOST_MEMORY;
             }
+            pPipelines[i] = wrapped_pipeline;
         }
     }
     return result;
@@ -323,12 +322,11 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipeli
                                                        const VkGraphicsPipelineCreateInfo *pCreateInfos,
                                                        const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines) {
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    safe_VkGraphicsPipelineCreateInfo *local_pCreateInfos = nullptr;
+    ScratchScope scratch;
+    VkGraphicsPipelineCreateInfo *local_pCreateInfos = nullptr;
     if (pCreateInfos) {
-        local_pCreateInfos = new safe_VkGraphicsPipelineCreateInfo[createInfoCount];
-        std::lock_guard<std::mutex> lock(global_lock);
+        local_pCreateInfos = scratch.Copy(pCreateInfos, createInfoCount);
         for (uint32_t idx0 = 0; idx0 < createInfoCount; ++idx0) {
-            local_pCreateInfos[idx0].initialize(&pCreateInfos[idx0]);
             if (pCreateInfos[idx0].basePipelineHandle) {
                 local_pCreateInfos[idx0].basePipelineHandle = Unwrap(device_data, pCreateInfos[idx0].basePipelineHandle);
             }
@@ -336,11 +334,13 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipeli
                 local_pCreateInfos[idx0].layout = Unwrap(device_data, pCreateInfos[idx0].layout);
             }
             if (pCreateInfos[idx0].pStages) {
+                auto local_pStages = scratch.Copy(pCreateInfos[idx0].pStages, pCreateInfos[idx0].stageCount);
                 for (uint32_t idx1 = 0; idx1 < pCreateInfos[idx0].stageCount; ++idx1) {
                     if (pCreateInfos[idx0].pStages[idx1].module) {
-                        local_pCreateInfos[idx0].pStages[idx1].module = Unwrap(device_data, pCreateInfos[idx0].pStages[idx1].module);
+                        local_pStages[idx1].module = Unwrap(device_data, pCreateInfos[idx0].pStages[idx1].module);
                     }
                 }
+                local_pCreateInfos[idx0].pStages = local_pStages;
             }
             if (pCreateInfos[idx0].renderPass) {
                 local_pCreateInfos[idx0].renderPass = Unwrap(device_data, pCreateInfos[idx0].renderPass);
@@ -348,19 +348,19 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipeli
         }
     }
     if (pipelineCache) {
-        std::lock_guard<std::mutex> lock(global_lock);
         pipelineCache = Unwrap(device_data, pipelineCache);
     }
 
-    VkResult result = device_data->dispatch_table.CreateGraphicsPipelines(
-        device, pipelineCache, createInfoCount, local_pCreateInfos->ptr(), pAllocator, pPipelines);
-    delete[] local_pCreateInfos;
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        for (uint32_t i = 0; i < createInfoCount; ++i) {
-            if (pPipelines[i] != VK_NULL_HANDLE) {
-                pPipelines[i] = WrapNew(device_data, pPipelines[i]);
+    VkResult result = device_data->dispatch_table.CreateGraphicsPipelines(device, pipelineCache, createInfoCount,
+                                                                          local_pCreateInfos, pAllocator, pPipelines);
+    for (uint32_t i = 0; i < createInfoCount; ++i) {
+        if (pPipelines[i] != VK_NULL_HANDLE) {
+            VkPipeline wrapped_pipeline = WrapNew(device_data, pPipelines[i]);
+            if (wrapped_pipeline == VK_NULL_HANDLE) {
+                device_data->dispatch_table.DestroyPipeline(device, pPipelines[i], pAllocator);
+                result = VK_ERROR_OUT_OF_HOST_MEMORY;
             }
+            pPipelines[i] = wrapped_pipeline;
         }
     }
     return result;
@@ -369,23 +369,23 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateGraphicsPipelines(VkDevice device, VkPipeli
 VKAPI_ATTR VkResult VKAPI_CALL CreateSwapchainKHR(VkDevice device, const VkSwapchainCreateInfoKHR *pCreateInfo,
                                                   const VkAllocationCallbacks *pAllocator, VkSwapchainKHR *pSwapchain) {
     layer_data *my_map_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    safe_VkSwapchainCreateInfoKHR *local_pCreateInfo = NULL;
+    ScratchScope scratch;
+    VkSwapchainCreateInfoKHR *local_pCreateInfo = NULL;
     if (pCreateInfo) {
-        std::lock_guard<std::mutex> lock(global_lock);
-        local_pCreateInfo = new safe_VkSwapchainCreateInfoKHR(pCreateInfo);
+        local_pCreateInfo = scratch.Copy(pCreateInfo);
         local_pCreateInfo->oldSwapchain = Unwrap(my_map_data, pCreateInfo->oldSwapchain);
         // Surface is instance-level object
         local_pCreateInfo->surface = Unwrap(my_map_data->instance_data, pCreateInfo->surface);
     }
 
-    VkResult result = my_map_data->dispatch_table.CreateSwapchainKHR(
-        device, local_pCreateInfo->ptr(), pAllocator, pSwapchain);
-    if (local_pCreateInfo) {
-        delete local_pCreateInfo;
-    }
+    VkResult result = my_map_data->dispatch_table.CreateSwapchainKHR(device, local_pCreateInfo, pAllocator, pSwapchain);
     if (VK_SUCCESS == result) {
-        std::lock_guard<std::mutex> lock(global_lock);
-        *pSwapchain = WrapNew(my_map_data, *pSwapchain);
+        VkSwapchainKHR wrapped_swapchain = WrapNew(my_map_data, *pSwapchain);
+        if (wrapped_swapchain == VK_NULL_HANDLE) {
+            my_map_data->dispatch_table.DestroySwapchainKHR(device, *pSwapchain, pAllocator);
+            result = VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        *pSwapchain = wrapped_swapchain;
     }
     return result;
 }
@@ -394,30 +394,36 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateSharedSwapchainsKHR(VkDevice device, uint32
                                                          const VkSwapchainCreateInfoKHR *pCreateInfos,
                                                          const VkAllocationCallbacks *pAllocator, VkSwapchainKHR *pSwapchains) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    safe_VkSwapchainCreateInfoKHR *local_pCreateInfos = NULL;
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        if (pCreateInfos) {
-            local_pCreateInfos = new safe_VkSwapchainCreateInfoKHR[swapchainCount];
-            for (uint32_t i = 0; i < swapchainCount; ++i) {
-                local_pCreateInfos[i].initialize(&pCreateInfos[i]);
-                if (pCreateInfos[i].surface) {
-                    // Surface is instance-level object
-                    local_pCreateInfos[i].surface = Unwrap(dev_data->instance_data, pCreateInfos[i].surface);
-                }
-                if (pCreateInfos[i].oldSwapchain) {
-                    local_pCreateInfos[i].oldSwapchain = Unwrap(dev_data, pCreateInfos[i].oldSwapchain);
-                }
+    ScratchScope scratch;
+    VkSwapchainCreateInfoKHR *local_pCreateInfos = NULL;
+    if (pCreateInfos) {
+        local_pCreateInfos = scratch.Copy(pCreateInfos, swapchainCount);
+        for (uint32_t i = 0; i < swapchainCount; ++i) {
+            if (pCreateInfos[i].surface) {
+                // Surface is instance-level object
+                local_pCreateInfos[i].surface = Unwrap(dev_data->instance_data, pCreateInfos[i].surface);
+            }
+            if (pCreateInfos[i].oldSwapchain) {
+                local_pCreateInfos[i].oldSwapchain = Unwrap(dev_data, pCreateInfos[i].oldSwapchain);
             }
         }
     }
-    VkResult result = dev_data->dispatch_table.CreateSharedSwapchainsKHR(
-        device, swapchainCount, local_pCreateInfos->ptr(), pAllocator, pSwapchains);
-    if (local_pCreateInfos) delete[] local_pCreateInfos;
+    VkResult result =
+        dev_data->dispatch_table.CreateSharedSwapchainsKHR(device, swapchainCount, local_pCreateInfos, pAllocator, pSwapchains);
     if (VK_SUCCESS == result) {
-        std::lock_guard<std::mutex> lock(global_lock);
         for (uint32_t i = 0; i < swapchainCount; i++) {
-            pSwapchains[i] = WrapNew(dev_data, pSwapchains[i]);
+            VkSwapchainKHR wrapped_swapchain = WrapNew(dev_data, pSwapchains[i]);
+            if (wrapped_swapchain == VK_NULL_HANDLE) {
+                // Out of unique IDs: the swapchains are created all or none, so release every one of them
+                for (uint32_t j = 0; j < swapchainCount; j++) {
+                    VkSwapchainKHR swapchain = (j < i) ? UnwrapAndErase(dev_data, pSwapchains[j]) : pSwapchains[j];
+                    dev_data->dispatch_table.DestroySwapchainKHR(device, swapchain, pAllocator);
+                    pSwapchains[j] = VK_NULL_HANDLE;
+                }
+                result = VK_ERROR_OUT_OF_HOST_MEMORY;
+                break;
+            }
+            pSwapchains[i] = wrapped_swapchain;
         }
     }
     return result;
@@ -426,54 +432,70 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateSharedSwapchainsKHR(VkDevice device, uint32
 VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesKHR(VkDevice device, VkSwapchainKHR swapchain, uint32_t *pSwapchainImageCount,
                                                      VkImage *pSwapchainImages) {
     layer_data *my_device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    uint64_t swapchain_id = reinterpret_cast<uint64_t &>(swapchain);
     if (VK_NULL_HANDLE != swapchain) {
-        std::lock_guard<std::mutex> lock(global_lock);
         swapchain = Unwrap(my_device_data, swapchain);
     }
     VkResult result =
         my_device_data->dispatch_table.GetSwapchainImagesKHR(device, swapchain, pSwapchainImageCount, pSwapchainImages);
-    // TODO : Need to add corresponding code to delete these images
-    if (VK_SUCCESS == result) {
+    if ((VK_SUCCESS == result) || (VK_INCOMPLETE == result)) {
         if ((*pSwapchainImageCount > 0) && pSwapchainImages) {
             std::lock_guard<std::mutex> lock(global_lock);
+            auto &wrapped_images = my_device_data->swapchain_wrapped_image_handle_map[swapchain_id];
+            for (uint32_t i = static_cast<uint32_t>(wrapped_images.size()); i < *pSwapchainImageCount; ++i) {
+                VkImage wrapped_image = WrapNew(my_device_data, pSwapchainImages[i]);
+                if (wrapped_image == VK_NULL_HANDLE) {
+                    // Out of unique IDs; the images wrapped so far are kept for the next query
+                    return VK_ERROR_OUT_OF_HOST_MEMORY;
+                }
+                wrapped_images.push_back(wrapped_image);
+            }
             for (uint32_t i = 0; i < *pSwapchainImageCount; ++i) {
-                pSwapchainImages[i] = WrapNew(my_device_data, pSwapchainImages[i]);
+                pSwapchainImages[i] = wrapped_images[i];
             }
         }
     }
     return result;
 }
 
+VKAPI_ATTR void VKAPI_CALL DestroySwapchainKHR(VkDevice device, VkSwapchainKHR swapchain, const VkAllocationCallbacks *pAllocator) {
+    layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
+    std::unique_lock<std::mutex> lock(global_lock);
+    auto image_array_it = dev_data->swapchain_wrapped_image_handle_map.find(reinterpret_cast<uint64_t &>(swapchain));
+    if (image_array_it != dev_data->swapchain_wrapped_image_handle_map.end()) {
+        for (auto image : image_array_it->second) {
+            UnwrapAndErase(dev_data, image);
+        }
+        dev_data->swapchain_wrapped_image_handle_map.erase(image_array_it);
+    }
+    swapchain = UnwrapAndErase(dev_data, swapchain);
+    lock.unlock();
+    dev_data->dispatch_table.DestroySwapchainKHR(device, swapchain, pAllocator);
+}
+
 VKAPI_ATTR VkResult VKAPI_CALL QueuePresentKHR(VkQueue queue, const VkPresentInfoKHR *pPresentInfo) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(queue), layer_data_map);
-    safe_VkPresentInfoKHR *local_pPresentInfo = NULL;
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        if (pPresentInfo) {
-            local_pPresentInfo = new safe_VkPresentInfoKHR(pPresentInfo);
-            if (local_pPresentInfo->pWaitSemaphores) {
-                for (uint32_t index1 = 0; index1 < local_pPresentInfo->waitSemaphoreCount; ++index1) {
-                    local_pPresentInfo->pWaitSemaphores[index1] = Unwrap(dev_data, pPresentInfo->pWaitSemaphores[index1]);
-                }
-            }
-            if (local_pPresentInfo->pSwapchains) {
-                for (uint32_t index1 = 0; index1 < local_pPresentInfo->swapchainCount; ++index1) {
-                    local_pPresentInfo->pSwapchains[index1] = Unwrap(dev_data, pPresentInfo->pSwapchains[index1]);
-                }
+    ScratchScope scratch;
+    VkPresentInfoKHR *local_pPresentInfo = NULL;
+    if (pPresentInfo) {
+        // pResults is an output array, so the copy keeps pointing at the application's array
+        local_pPresentInfo = scratch.Copy(pPresentInfo);
+        if (pPresentInfo->pWaitSemaphores) {
+            auto local_pWaitSemaphores = scratch.Alloc<VkSemaphore>(pPresentInfo->waitSemaphoreCount);
+            for (uint32_t index1 = 0; index1 < pPresentInfo->waitSemaphoreCount; ++index1) {
+                local_pWaitSemaphores[index1] = Unwrap(dev_data, pPresentInfo->pWaitSemaphores[index1]);
             }
+            local_pPresentInfo->pWaitSemaphores = local_pWaitSemaphores;
         }
-    }
-    VkResult result = dev_data->dispatch_table.QueuePresentKHR(queue, local_pPresentInfo->ptr());
-
-    // pResults is an output array embedded in a structure. The code generator neglects to copy back from the safe_* version,
-    // so handle it as a special case here:
-    if (pPresentInfo && pPresentInfo->pResults) {
-        for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
-            pPresentInfo->pResults[i] = local_pPresentInfo->pResults[i];
+        if (pPresentInfo->pSwapchains) {
+            auto local_pSwapchains = scratch.Alloc<VkSwapchainKHR>(pPresentInfo->swapchainCount);
+            for (uint32_t index1 = 0; index1 < pPresentInfo->swapchainCount; ++index1) {
+                local_pSwapchains[index1] = Unwrap(dev_data, pPresentInfo->pSwapchains[index1]);
+            }
+            local_pPresentInfo->pSwapchains = local_pSwapchains;
         }
     }
-
-    if (local_pPresentInfo) delete local_pPresentInfo;
+    VkResult result = dev_data->dispatch_table.QueuePresentKHR(queue, local_pPresentInfo);
     return result;
 }
 
@@ -483,28 +505,33 @@ VKAPI_ATTR VkResult VKAPI_CALL CreateDescriptorUpdateTemplateKHR(VkDevice device
                                                                  VkDescriptorUpdateTemplateKHR *pDescriptorUpdateTemplate) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
     safe_VkDescriptorUpdateTemplateCreateInfoKHR *local_create_info = NULL;
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        if (pCreateInfo) {
-            local_create_info = new safe_VkDescriptorUpdateTemplateCreateInfoKHR(pCreateInfo);
-            if (pCreateInfo->descriptorSetLayout) {
-                local_create_info->descriptorSetLayout = Unwrap(dev_data, pCreateInfo->descriptorSetLayout);
-            }
-            if (pCreateInfo->pipelineLayout) {
-                local_create_info->pipelineLayout = Unwrap(dev_data, pCreateInfo->pipelineLayout);
-            }
+    if (pCreateInfo) {
+        local_create_info = new safe_VkDescriptorUpdateTemplateCreateInfoKHR(pCreateInfo);
+        if (pCreateInfo->descriptorSetLayout) {
+            local_create_info->descriptorSetLayout = Unwrap(dev_data, pCreateInfo->descriptorSetLayout);
+        }
+        if (pCreateInfo->pipelineLayout) {
+            local_create_info->pipelineLayout = Unwrap(dev_data, pCreateInfo->pipelineLayout);
         }
     }
     VkResult result = dev_data->dispatch_table.CreateDescriptorUpdateTemplateKHR(
         device, local_create_info->ptr(), pAllocator, pDescriptorUpdateTemplate);
     if (VK_SUCCESS == result) {
-        std::lock_guard<std::mutex> lock(global_lock);
-        *pDescriptorUpdateTemplate = WrapNew(dev_data, *pDescriptorUpdateTemplate);
+        VkDescriptorUpdateTemplateKHR wrapped_template = WrapNew(dev_data, *pDescriptorUpdateTemplate);
+        if (wrapped_template == VK_NULL_HANDLE) {
+            dev_data->dispatch_table.DestroyDescriptorUpdateTemplateKHR(device, *pDescriptorUpdateTemplate, pAllocator);
+            *pDescriptorUpdateTemplate = VK_NULL_HANDLE;
+            delete local_create_info;
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+        *pDescriptorUpdateTemplate = wrapped_template;
 
         // Shadow template createInfo for later updates
+        std::lock_guard<std::mutex> lock(global_lock);
         std::unique_ptr<TEMPLATE_STATE> template_state(new TEMPLATE_STATE(*pDescriptorUpdateTemplate, local_create_info));
         dev_data->desc_template_map[(uint64_t)*pDescriptorUpdateTemplate] = std::move(template_state);
     }
+    delete local_create_info;
     return result;
 }
 
@@ -515,39 +542,66 @@ VKAPI_ATTR void VKAPI_CALL DestroyDescriptorUpdateTemplateKHR(VkDevice device,
     std::unique_lock<std::mutex> lock(global_lock);
     uint64_t descriptor_update_template_id = reinterpret_cast<uint64_t &>(descriptorUpdateTemplate);
     dev_data->desc_template_map.erase(descriptor_update_template_id);
-    descriptorUpdateTemplate = (VkDescriptorUpdateTemplateKHR)dev_data->unique_id_mapping[descriptor_update_template_id];
-    dev_data->unique_id_mapping.erase(descriptor_update_template_id);
+    descriptorUpdateTemplate = UnwrapAndErase(dev_data, descriptorUpdateTemplate);
     lock.unlock();
     dev_data->dispatch_table.DestroyDescriptorUpdateTemplateKHR(device, descriptorUpdateTemplate, pAllocator);
 }
 
-void *BuildUnwrappedUpdateTemplateBuffer(layer_data *dev_data, uint64_t descriptorUpdateTemplate, const void *pData) {
-    auto const template_map_entry = dev_data->desc_template_map.find(descriptorUpdateTemplate);
-    if (template_map_entry == dev_data->desc_template_map.end()) {
-        assert(0);
+// Return the size of one descriptor of the given type in descriptor update template data
+static size_t TemplateDescriptorSize(VkDescriptorType type) {
+    if (DescriptorTypeUsesImageInfo(type)) return sizeof(VkDescriptorImageInfo);
+    if (DescriptorTypeUsesBufferInfo(type)) return sizeof(VkDescriptorBufferInfo);
+    if (DescriptorTypeUsesTexelBufferView(type)) return sizeof(VkBufferView);
+    assert(0);
+    return 0;
+}
+
+void *BuildUnwrappedUpdateTemplateBuffer(layer_data *dev_data, ScratchScope &scratch, uint64_t descriptorUpdateTemplate,
+                                         const void *pData) {
+    // The template may be destroyed on another thread once the lock is dropped, so work from a copy of its entries
+    uint32_t entry_count = 0;
+    VkDescriptorUpdateTemplateEntryKHR *entries = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(global_lock);
+        auto const template_map_entry = dev_data->desc_template_map.find(descriptorUpdateTemplate);
+        if (template_map_entry == dev_data->desc_template_map.end()) {
+            assert(0);
+            return nullptr;
+        }
+        auto const &template_create_info = template_map_entry->second->create_info;
+        entry_count = template_create_info.descriptorUpdateEntryCount;
+        entries = scratch.Copy(template_create_info.pDescriptorUpdateEntries, entry_count);
     }
-    auto const &create_info = template_map_entry->second->create_info;
+
+    // Size the buffer to cover the last descriptor of every entry
     size_t allocation_size = 0;
-    std::vector<std::tuple<size_t, VulkanObjectType, void *>> template_entries;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        auto const &entry = entries[i];
+        if (entry.descriptorCount) {
+            allocation_size = std::max(allocation_size, entry.offset + (entry.descriptorCount - 1) * entry.stride +
+                                                            TemplateDescriptorSize(entry.descriptorType));
+        }
+    }
 
-    for (uint32_t i = 0; i < create_info.descriptorUpdateEntryCount; i++) {
-        for (uint32_t j = 0; j < create_info.pDescriptorUpdateEntries[i].descriptorCount; j++) {
-            size_t offset = create_info.pDescriptorUpdateEntries[i].offset + j * create_info.pDescriptorUpdateEntries[i].stride;
+    // Populate the buffer with unwrapped copies of the source data
+    char *unwrapped_data = scratch.Alloc<char>(allocation_size);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        for (uint32_t j = 0; j < entries[i].descriptorCount; j++) {
+            size_t offset = entries[i].offset + j * entries[i].stride;
             char *update_entry = (char *)(pData) + offset;
+            char *destination = unwrapped_data + offset;
 
-            switch (create_info.pDescriptorUpdateEntries[i].descriptorType) {
+            switch (entries[i].descriptorType) {
                 case VK_DESCRIPTOR_TYPE_SAMPLER:
                 case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
                 case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
                 case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
                 case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: {
                     auto image_entry = reinterpret_cast<VkDescriptorImageInfo *>(update_entry);
-                    allocation_size = std::max(allocation_size, offset + sizeof(VkDescriptorImageInfo));
-
-                    VkDescriptorImageInfo *wrapped_entry = new VkDescriptorImageInfo(*image_entry);
+                    auto wrapped_entry = reinterpret_cast<VkDescriptorImageInfo *>(destination);
+                    *wrapped_entry = *image_entry;
                     wrapped_entry->sampler = Unwrap(dev_data, image_entry->sampler);
                     wrapped_entry->imageView = Unwrap(dev_data, image_entry->imageView);
-                    template_entries.emplace_back(offset, kVulkanObjectTypeImage, reinterpret_cast<void *>(wrapped_entry));
                 } break;
 
                 case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
@@ -555,20 +609,15 @@ void *BuildUnwrappedUpdateTemplateBuffer(layer_data *dev_data, uint64_t descript
                 case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
                 case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC: {
                     auto buffer_entry = reinterpret_cast<VkDescriptorBufferInfo *>(update_entry);
-                    allocation_size = std::max(allocation_size, offset + sizeof(VkDescriptorBufferInfo));
-
-                    VkDescriptorBufferInfo *wrapped_entry = new VkDescriptorBufferInfo(*buffer_entry);
+                    auto wrapped_entry = reinterpret_cast<VkDescriptorBufferInfo *>(destination);
+                    *wrapped_entry = *buffer_entry;
                     wrapped_entry->buffer = Unwrap(dev_data, buffer_entry->buffer);
-                    template_entries.emplace_back(offset, kVulkanObjectTypeBuffer, reinterpret_cast<void *>(wrapped_entry));
                 } break;
 
                 case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
                 case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: {
                     auto buffer_view_handle = reinterpret_cast<VkBufferView *>(update_entry);
-                    allocation_size = std::max(allocation_size, offset + sizeof(VkBufferView));
-
-                    VkBufferView wrapped_entry = Unwrap(dev_data, *buffer_view_handle);
-                    template_entries.emplace_back(offset, kVulkanObjectTypeBufferView, reinterpret_cast<void *>(wrapped_entry));
+                    *(reinterpret_cast<VkBufferView *>(destination)) = Unwrap(dev_data, *buffer_view_handle);
                 } break;
                 default:
                     assert(0);
@@ -576,30 +625,6 @@ void *BuildUnwrappedUpdateTemplateBuffer(layer_data *dev_data, uint64_t descript
             }
         }
     }
-    // Allocate required buffer size and populate with source/unwrapped data
-    void *unwrapped_data = malloc(allocation_size);
-    for (auto &this_entry : template_entries) {
-        VulkanObjectType type = std::get<1>(this_entry);
-        void *destination = (char *)unwrapped_data + std::get<0>(this_entry);
-        void *source = (char *)std::get<2>(this_entry);
-
-        switch (type) {
-            case kVulkanObjectTypeImage:
-                *(reinterpret_cast<VkDescriptorImageInfo *>(destination)) = *(reinterpret_cast<VkDescriptorImageInfo *>(source));
-                delete reinterpret_cast<VkDescriptorImageInfo *>(source);
-                break;
-            case kVulkanObjectTypeBuffer:
-                *(reinterpret_cast<VkDescriptorBufferInfo *>(destination)) = *(reinterpret_cast<VkDescriptorBufferInfo *>(source));
-                delete reinterpret_cast<VkDescriptorBufferInfo *>(source);
-                break;
-            case kVulkanObjectTypeBufferView:
-                *(reinterpret_cast<VkBufferView *>(destination)) = reinterpret_cast<VkBufferView>(source);
-                break;
-            default:
-                assert(0);
-                break;
-        }
-    }
     return (void *)unwrapped_data;
 }
 
@@ -608,15 +633,12 @@ VKAPI_ATTR void VKAPI_CALL UpdateDescriptorSetWithTemplateKHR(VkDevice device, V
                                                               const void *pData) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
     uint64_t template_handle = reinterpret_cast<uint64_t &>(descriptorUpdateTemplate);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        descriptorSet = Unwrap(dev_data, descriptorSet);
-        descriptorUpdateTemplate = (VkDescriptorUpdateTemplateKHR)dev_data->unique_id_mapping[template_handle];
-    }
-    void *unwrapped_buffer = BuildUnwrappedUpdateTemplateBuffer(dev_data, template_handle, pData);
+    descriptorSet = Unwrap(dev_data, descriptorSet);
+    descriptorUpdateTemplate = Unwrap(dev_data, descriptorUpdateTemplate);
+    ScratchScope scratch;
+    void *unwrapped_buffer = BuildUnwrappedUpdateTemplateBuffer(dev_data, scratch, template_handle, pData);
     dev_data->dispatch_table.UpdateDescriptorSetWithTemplateKHR(device, descriptorSet, descriptorUpdateTemplate,
                                                                         unwrapped_buffer);
-    free(unwrapped_buffer);
 }
 
 VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer commandBuffer,
@@ -624,15 +646,12 @@ VKAPI_ATTR void VKAPI_CALL CmdPushDescriptorSetWithTemplateKHR(VkCommandBuffer c
                                                                VkPipelineLayout layout, uint32_t set, const void *pData) {
     layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(commandBuffer), layer_data_map);
     uint64_t template_handle = reinterpret_cast<uint64_t &>(descriptorUpdateTemplate);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        descriptorUpdateTemplate = Unwrap(dev_data, descriptorUpdateTemplate);
-        layout = Unwrap(dev_data, layout);
-    }
-    void *unwrapped_buffer = BuildUnwrappedUpdateTemplateBuffer(dev_data, template_handle, pData);
+    descriptorUpdateTemplate = Unwrap(dev_data, descriptorUpdateTemplate);
+    layout = Unwrap(dev_data, layout);
+    ScratchScope scratch;
+    void *unwrapped_buffer = BuildUnwrappedUpdateTemplateBuffer(dev_data, scratch, template_handle, pData);
     dev_data->dispatch_table.CmdPushDescriptorSetWithTemplateKHR(commandBuffer, descriptorUpdateTemplate, layout, set,
                                                                          unwrapped_buffer);
-    free(unwrapped_buffer);
 }
 
 #ifndef __ANDROID__
@@ -645,7 +664,7 @@ VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceDisplayPropertiesKHR(VkPhysicalD
     if ((result == VK_SUCCESS || result == VK_INCOMPLETE) && pProperties) {
         std::lock_guard<std::mutex> lock(global_lock);
         for (uint32_t idx0 = 0; idx0 < *pPropertyCount; ++idx0) {
-            pProperties[idx0].display = WrapNew(my_map_data, pProperties[idx0].display);
+            pProperties[idx0].display = WrapDisplayObject(my_map_data, pProperties[idx0].display);
         }
     }
     return result;
@@ -660,10 +679,7 @@ VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneSupportedDisplaysKHR(VkPhysicalDev
         if ((*pDisplayCount > 0) && pDisplays) {
             std::lock_guard<std::mutex> lock(global_lock);
             for (uint32_t i = 0; i < *pDisplayCount; i++) {
-                // TODO: this looks like it really wants a /reverse/ mapping. What's going on here?
-                auto it = my_map_data->unique_id_mapping.find(reinterpret_cast<const uint64_t &>(pDisplays[i]));
-                assert(it != my_map_data->unique_id_mapping.end());
-                pDisplays[i] = reinterpret_cast<VkDisplayKHR &>(it->second);
+                pDisplays[i] = WrapDisplayObject(my_map_data, pDisplays[i]);
             }
         }
     }
@@ -673,17 +689,14 @@ VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneSupportedDisplaysKHR(VkPhysicalDev
 VKAPI_ATTR VkResult VKAPI_CALL GetDisplayModePropertiesKHR(VkPhysicalDevice physicalDevice, VkDisplayKHR display,
                                                            uint32_t *pPropertyCount, VkDisplayModePropertiesKHR *pProperties) {
     instance_layer_data *my_map_data = GetLayerDataPtr(get_dispatch_key(physicalDevice), instance_layer_data_map);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        display = Unwrap(my_map_data, display);
-    }
+    display = Unwrap(my_map_data, display);
 
     VkResult result = my_map_data->dispatch_table.GetDisplayModePropertiesKHR(
         physicalDevice, display, pPropertyCount, pProperties);
-    if (result == VK_SUCCESS && pProperties) {
+    if ((result == VK_SUCCESS || result == VK_INCOMPLETE) && pProperties) {
         std::lock_guard<std::mutex> lock(global_lock);
         for (uint32_t idx0 = 0; idx0 < *pPropertyCount; ++idx0) {
-            pProperties[idx0].displayMode = WrapNew(my_map_data, pProperties[idx0].displayMode);
+            pProperties[idx0].displayMode = WrapDisplayObject(my_map_data, pProperties[idx0].displayMode);
         }
     }
     return result;
@@ -692,10 +705,7 @@ VKAPI_ATTR VkResult VKAPI_CALL GetDisplayModePropertiesKHR(VkPhysicalDevice phys
 VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneCapabilitiesKHR(VkPhysicalDevice physicalDevice, VkDisplayModeKHR mode,
                                                               uint32_t planeIndex, VkDisplayPlaneCapabilitiesKHR *pCapabilities) {
     instance_layer_data *dev_data = GetLayerDataPtr(get_dispatch_key(physicalDevice), instance_layer_data_map);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        mode = Unwrap(dev_data, mode);
-    }
+    mode = Unwrap(dev_data, mode);
     VkResult result =
         dev_data->dispatch_table.GetDisplayPlaneCapabilitiesKHR(physicalDevice, mode, planeIndex, pCapabilities);
     return result;
@@ -704,31 +714,23 @@ VKAPI_ATTR VkResult VKAPI_CALL GetDisplayPlaneCapabilitiesKHR(VkPhysicalDevice p
 
 VKAPI_ATTR VkResult VKAPI_CALL DebugMarkerSetObjectTagEXT(VkDevice device, VkDebugMarkerObjectTagInfoEXT *pTagInfo) {
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    auto local_tag_info = new safe_VkDebugMarkerObjectTagInfoEXT(pTagInfo);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        auto it = device_data->unique_id_mapping.find(reinterpret_cast<uint64_t &>(local_tag_info->object));
-        if (it != device_data->unique_id_mapping.end()) {
-            local_tag_info->object = it->second;
-        }
+    VkDebugMarkerObjectTagInfoEXT local_tag_info = *pTagInfo;
+    auto handle = device_data->unique_id_mapping.Find(local_tag_info.object);
+    if (handle) {
+        local_tag_info.object = handle;
     }
-    VkResult result = device_data->dispatch_table.DebugMarkerSetObjectTagEXT(
-        device, reinterpret_cast<VkDebugMarkerObjectTagInfoEXT *>(local_tag_info));
+    VkResult result = device_data->dispatch_table.DebugMarkerSetObjectTagEXT(device, &local_tag_info);
     return result;
 }
 
 VKAPI_ATTR VkResult VKAPI_CALL DebugMarkerSetObjectNameEXT(VkDevice device, VkDebugMarkerObjectNameInfoEXT *pNameInfo) {
     layer_data *device_data = GetLayerDataPtr(get_dispatch_key(device), layer_data_map);
-    auto local_name_info = new safe_VkDebugMarkerObjectNameInfoEXT(pNameInfo);
-    {
-        std::lock_guard<std::mutex> lock(global_lock);
-        auto it = device_data->unique_id_mapping.find(reinterpret_cast<uint64_t &>(local_name_info->object));
-        if (it != device_data->unique_id_mapping.end()) {
-            local_name_info->object = it->second;
-        }
+    VkDebugMarkerObjectNameInfoEXT local_name_info = *pNameInfo;
+    auto handle = device_data->unique_id_mapping.Find(local_name_info.object);
+    if (handle) {
+        local_name_info.object = handle;
     }
-    VkResult result = device_data->dispatch_table.DebugMarkerSetObjectNameEXT(
-        device, reinterpret_cast<VkDebugMarkerObjectNameInfoEXT *>(local_name_info));
+    VkResult result = device_data->dispatch_table.DebugMarkerSetObjectNameEXT(device, &local_name_info);
     return result;
 }
 
@@ -24,14 +24,241 @@
 #include "vk_layer_data.h"
 #include "vk_safe_struct.h"
 #include "vk_layer_utils.h"
+#include "vk_loader_platform.h"
 #include "mutex"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #pragma once
 
 namespace unique_objects {
 
-// All increments must be guarded by global_lock
-static uint64_t global_unique_id = 1;
+// Tags of the unique id tables created so far, so that ids handed out by different tables never collide
+static std::atomic<uint32_t> unique_id_table_count(0);
+
+// Maps the unique ids handed out by this layer back to the driver's handles. An id is the index of the slot holding the
+// handle, tagged with the slot's generation and the table it belongs to, so unwrapping is a lock-free load from one slot
+// and an id that was destroyed no longer matches its slot. Slots live in fixed-size blocks that are never moved or freed
+// while the table lives, so readers stay valid while other threads grow the table; only Insert and Erase take a lock.
+// A slot whose generation wraps around is retired rather than reused, so a stale id can never match a later handle.
+class UniqueIdTable {
+   public:
+    UniqueIdTable() : tag_((unique_id_table_count++ % kTagMask) + 1), slot_count_(0) {
+        for (auto &block : blocks_) block.store(nullptr, std::memory_order_relaxed);
+    }
+    ~UniqueIdTable() {
+        for (auto &block : blocks_) delete[] block.load(std::memory_order_relaxed);
+    }
+
+    // Return a new unique id for handle, or 0 if every slot is in use or retired
+    uint64_t Insert(uint64_t handle) {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        uint32_t index;
+        if (!free_slots_.empty()) {
+            index = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            if (slot_count_ == kBlockCount * kBlockSize) return 0;
+            index = slot_count_++;
+            if (index % kBlockSize == 0) {
+                blocks_[index / kBlockSize].store(new Slot[kBlockSize], std::memory_order_release);
+            }
+        }
+        Slot &slot = GetSlot(index);
+        slot.handle.store(handle, std::memory_order_relaxed);
+        uint64_t generation = slot.generation.load(std::memory_order_relaxed);
+        return (static_cast<uint64_t>(tag_) << kTagShift) | (generation << kGenerationShift) | index;
+    }
+
+    // Return the handle behind a unique id, or 0 if the id isn't live in this table
+    uint64_t Find(uint64_t unique_id) const {
+        Slot const *slot = LookupSlot(unique_id);
+        return slot ? slot->handle.load(std::memory_order_relaxed) : 0;
+    }
+
+    // Retire a unique id, returning the handle it stood for or 0 if the id isn't live in this table
+    uint64_t Erase(uint64_t unique_id) {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        Slot *slot = const_cast<Slot *>(LookupSlot(unique_id));
+        if (!slot) return 0;
+        uint64_t handle = slot->handle.exchange(0, std::memory_order_relaxed);
+        uint64_t generation = (slot->generation.load(std::memory_order_relaxed) + 1) & kGenerationMask;
+        slot->generation.store(generation, std::memory_order_release);
+        // Every generation of this slot has been handed out; reusing it would make old ids valid again
+        if (generation != 0) free_slots_.push_back(static_cast<uint32_t>(unique_id & kIndexMask));
+        return handle;
+    }
+
+   private:
+    // Unique id layout: | tag (16 bits) | generation (24 bits) | slot index (24 bits) |
+    static const uint32_t kIndexBits = 24;
+    static const uint64_t kIndexMask = (1ull << kIndexBits) - 1;
+    static const uint32_t kGenerationShift = kIndexBits;
+    static const uint64_t kGenerationMask = (1ull << 24) - 1;
+    static const uint32_t kTagShift = 48;
+    static const uint32_t kTagMask = 0xFFFF;
+    static const uint32_t kBlockSize = 4096;
+    static const uint32_t kBlockCount = (1u << kIndexBits) / kBlockSize;
+
+    struct Slot {
+        std::atomic<uint64_t> handle;
+        std::atomic<uint64_t> generation;
+        Slot() : handle(0), generation(0) {}
+    };
+
+    Slot &GetSlot(uint32_t index) { return blocks_[index / kBlockSize].load(std::memory_order_acquire)[index % kBlockSize]; }
+
+    Slot const *LookupSlot(uint64_t unique_id) const {
+        if ((unique_id >> kTagShift) != tag_) return nullptr;
+        uint64_t index = unique_id & kIndexMask;
+        Slot const *block = blocks_[index / kBlockSize].load(std::memory_order_acquire);
+        if (!block) return nullptr;
+        Slot const &slot = block[index % kBlockSize];
+        if (slot.generation.load(std::memory_order_acquire) != ((unique_id >> kGenerationShift) & kGenerationMask)) return nullptr;
+        return &slot;
+    }
+
+    const uint32_t tag_;
+    std::atomic<Slot *> blocks_[kBlockCount];
+    std::mutex write_lock_;  // Serializes Insert and Erase
+    uint32_t slot_count_;
+    std::vector<uint32_t> free_slots_;
+};
+
+// Bump allocator for the unwrapped copies of a call's parameters. Blocks are kept after a Rewind, so once a thread's arena
+// has grown to fit its largest call, copying parameters no longer touches the heap.
+class ScratchArena {
+   public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    ScratchArena() : block_(0), offset_(0) {}
+
+    void *Allocate(size_t size) {
+        size = (size + kAlignment - 1) & ~(kAlignment - 1);
+        for (; block_ < blocks_.size(); ++block_, offset_ = 0) {
+            if (offset_ + size <= block_sizes_[block_]) {
+                void *allocation = blocks_[block_].get() + offset_;
+                offset_ += size;
+                return allocation;
+            }
+        }
+        size_t block_size = (size > kBlockSize) ? size : kBlockSize;
+        blocks_.emplace_back(new char[block_size]);
+        block_sizes_.push_back(block_size);
+        offset_ = size;
+        return blocks_[block_].get();
+    }
+
+    template <typename T>
+    T *Alloc(size_t count) {
+        return static_cast<T *>(Allocate(sizeof(T) * count));
+    }
+
+    template <typename T>
+    T *Copy(const T *source, size_t count = 1) {
+        T *copy = Alloc<T>(count);
+        std::copy(source, source + count, copy);
+        return copy;
+    }
+
+    Mark GetMark() const { return Mark{block_, offset_}; }
+    void Rewind(const Mark &mark) {
+        block_ = mark.block;
+        offset_ = mark.offset;
+    }
+
+   private:
+    static const size_t kAlignment = 16;
+    static const size_t kBlockSize = 16 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<size_t> block_sizes_;
+    size_t block_;
+    size_t offset_;
+};
+
+// Frees each thread's scratch arena when the thread exits. The key is released when the layer is unloaded, so threads that
+// outlive the layer don't call back into unloaded code.
+class ScratchArenaReaper {
+   public:
+#if defined(_WIN32)
+    ScratchArenaReaper() : key_(FlsAlloc(FreeArena)) {}
+    ~ScratchArenaReaper() {
+        // FlsFree runs the callback for every thread still holding an arena
+        if (key_ != FLS_OUT_OF_INDEXES) FlsFree(key_);
+    }
+    void Track(ScratchArena *arena) {
+        if (key_ != FLS_OUT_OF_INDEXES) FlsSetValue(key_, arena);
+    }
+#else
+    ScratchArenaReaper() : valid_(pthread_key_create(&key_, FreeArena) == 0) {}
+    ~ScratchArenaReaper() {
+        if (!valid_) return;
+        FreeArena(pthread_getspecific(key_));
+        pthread_key_delete(key_);
+    }
+    void Track(ScratchArena *arena) {
+        if (valid_) pthread_setspecific(key_, arena);
+    }
+#endif
+
+   private:
+    ScratchArenaReaper(const ScratchArenaReaper &) = delete;
+    ScratchArenaReaper &operator=(const ScratchArenaReaper &) = delete;
+
+#if defined(_WIN32)
+    static void NTAPI FreeArena(void *arena) { delete static_cast<ScratchArena *>(arena); }
+
+    DWORD key_;
+#else
+    static void FreeArena(void *arena) { delete static_cast<ScratchArena *>(arena); }
+
+    pthread_key_t key_;
+    bool valid_;
+#endif
+};
+
+static ScratchArenaReaper scratch_arena_reaper;
+
+// Each thread's arena is created on first use and freed by scratch_arena_reaper when the thread exits
+static THREAD_LOCAL_DECL ScratchArena *thread_scratch_arena = nullptr;
+
+// Scratch memory for one intercepted call. Everything allocated through the scope is released when it goes out of scope.
+class ScratchScope {
+   public:
+    ScratchScope() : arena_(GetThreadArena()), mark_(arena_.GetMark()) {}
+    ~ScratchScope() { arena_.Rewind(mark_); }
+
+    template <typename T>
+    T *Alloc(size_t count) {
+        return arena_.Alloc<T>(count);
+    }
+
+    template <typename T>
+    T *Copy(const T *source, size_t count = 1) {
+        return arena_.Copy(source, count);
+    }
+
+   private:
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    static ScratchArena &GetThreadArena() {
+        if (!thread_scratch_arena) {
+            thread_scratch_arena = new ScratchArena;
+            scratch_arena_reaper.Track(thread_scratch_arena);
+        }
+        return *thread_scratch_arena;
+    }
+
+    ScratchArena &arena_;
+    const ScratchArena::Mark mark_;
+};
 
 struct TEMPLATE_STATE {
     VkDescriptorUpdateTemplateKHR desc_update_template;
@@ -54,7 +281,10 @@ struct instance_layer_data {
     VkDebugReportCallbackCreateInfoEXT *tmp_dbg_create_infos;
     VkDebugReportCallbackEXT *tmp_callbacks;
 
-    std::unordered_map<uint64_t, uint64_t> unique_id_mapping;  // Map uniqueID to actual object handle
+    UniqueIdTable unique_id_mapping;  // Map uniqueID to actual object handle
+    // Displays and display modes are returned by queries rather than created, so each keeps the uniqueID it was first
+    // given instead of taking a new one every time it is queried
+    std::unordered_map<uint64_t, uint64_t> display_id_reverse_mapping;
 };
 
 struct layer_data {
@@ -64,18 +294,21 @@ struct layer_data {
     VkLayerDispatchTable dispatch_table = {};
 
     std::unordered_map<uint64_t, std::unique_ptr<TEMPLATE_STATE>> desc_template_map;
+    // Map uniqueID of a swapchain to the uniqueIDs of its images, so re-querying the images returns the same IDs and
+    // destroying the swapchain retires them
+    std::unordered_map<uint64_t, std::vector<VkImage>> swapchain_wrapped_image_handle_map;
 
     bool wsi_enabled;
-    std::unordered_map<uint64_t, uint64_t> unique_id_mapping;  // Map uniqueID to actual object handle
+    UniqueIdTable unique_id_mapping;  // Map uniqueID to actual object handle
     VkPhysicalDevice gpu;
 
     layer_data() : wsi_enabled(false), gpu(VK_NULL_HANDLE){};
 };
 
-static std::unordered_map<void *, instance_layer_data *> instance_layer_data_map;
-static std::unordered_map<void *, layer_data *> layer_data_map;
+static LayerDataMap<instance_layer_data> instance_layer_data_map;
+static LayerDataMap<layer_data> layer_data_map;
 
-static std::mutex global_lock;  // Protect map accesses and unique_id increments
+static std::mutex global_lock;  // Protect desc_template_map accesses
 
 struct GenericHeader {
     VkStructureType sType;
@@ -99,22 +332,51 @@ bool ContainsExtStruct(const T *target, VkStructureType ext_type) {
     return false;
 }
 
+// VkWriteDescriptorSet only reads the descriptor array matching its descriptorType; the others may hold garbage
+inline bool DescriptorTypeUsesImageInfo(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+           type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+           type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+}
+
+inline bool DescriptorTypeUsesBufferInfo(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+           type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+}
+
+inline bool DescriptorTypeUsesTexelBufferView(VkDescriptorType type) {
+    return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+}
 
 /* Unwrap a handle. */
-// must hold lock!
+// Needs no lock
 template<typename HandleType, typename MapType>
 HandleType Unwrap(MapType *layer_data, HandleType wrappedHandle) {
-    // TODO: don't use operator[] here.
-    return (HandleType)layer_data->unique_id_mapping[reinterpret_cast<uint64_t const &>(wrappedHandle)];
+    return (HandleType)layer_data->unique_id_mapping.Find(reinterpret_cast<uint64_t const &>(wrappedHandle));
 }
 
-/* Wrap a newly created handle with a new unique ID, and return the new ID. */
-// must hold lock!
+/* Wrap a newly created handle with a new unique ID, and return the new ID, or VK_NULL_HANDLE if no ID is left. */
+// Needs no lock
 template<typename HandleType, typename MapType>
 HandleType WrapNew(MapType *layer_data, HandleType newlyCreatedHandle) {
-    auto unique_id = global_unique_id++;
-    layer_data->unique_id_mapping[unique_id] = reinterpret_cast<uint64_t const &>(newlyCreatedHandle);
+    auto unique_id = layer_data->unique_id_mapping.Insert(reinterpret_cast<uint64_t const &>(newlyCreatedHandle));
+    return (HandleType)unique_id;
+}
+
+/* Wrap a display or display mode handle, reusing the unique ID it was given by an earlier query. */
+// Needs global lock
+template<typename HandleType>
+HandleType WrapDisplayObject(instance_layer_data *layer_data, HandleType handle) {
+    uint64_t &unique_id = layer_data->display_id_reverse_mapping[reinterpret_cast<uint64_t const &>(handle)];
+    if (!unique_id) unique_id = layer_data->unique_id_mapping.Insert(reinterpret_cast<uint64_t const &>(handle));
     return (HandleType)unique_id;
 }
 
+/* Retire the unique ID of a destroyed handle, and return the handle it stood for. */
+// Needs no lock
+template<typename HandleType, typename MapType>
+HandleType UnwrapAndErase(MapType *layer_data, HandleType wrappedHandle) {
+    return (HandleType)layer_data->unique_id_mapping.Erase(reinterpret_cast<uint64_t const &>(wrappedHandle));
+}
+
 }  // namespace unique_objects
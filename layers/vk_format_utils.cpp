@@ -235,8 +235,10 @@ const std::map<VkFormat, VULKAN_FORMAT_INFO> vk_format_table = {
 // Renable formatting
 // clang-format on
 
+// The classification switches below are only evaluated while building vk_format_dense_table
+
 // Return true if format is an ETC2 or EAC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_ETC2_EAC(VkFormat format) {
+static bool ComputeFormatIsCompressed_ETC2_EAC(VkFormat format) {
     bool found = false;
 
     switch (format) {
@@ -259,7 +261,7 @@ VK_LAYER_EXPORT bool FormatIsCompressed_ETC2_EAC(VkFormat format) {
 }
 
 // Return true if format is an ASTC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_ASTC_LDR(VkFormat format) {
+static bool ComputeFormatIsCompressed_ASTC_LDR(VkFormat format) {
     bool found = false;
 
     switch (format) {
@@ -300,7 +302,7 @@ VK_LAYER_EXPORT bool FormatIsCompressed_ASTC_LDR(VkFormat format) {
 }
 
 // Return true if format is a BC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_BC(VkFormat format) {
+static bool ComputeFormatIsCompressed_BC(VkFormat format) {
     bool found = false;
 
     switch (format) {
@@ -329,7 +331,7 @@ VK_LAYER_EXPORT bool FormatIsCompressed_BC(VkFormat format) {
 }
 
 // Return true if format is a PVRTC compressed texture format
-VK_LAYER_EXPORT bool FormatIsCompressed_PVRTC(VkFormat format) {
+static bool ComputeFormatIsCompressed_PVRTC(VkFormat format) {
     bool found = false;
 
     switch (format) {
@@ -349,21 +351,8 @@ VK_LAYER_EXPORT bool FormatIsCompressed_PVRTC(VkFormat format) {
     return found;
 }
 
-// Return true if format is compressed
-VK_LAYER_EXPORT bool FormatIsCompressed(VkFormat format) {
-    return (FormatIsCompressed_ASTC_LDR(format) || 
-            FormatIsCompressed_BC(format) || 
-            FormatIsCompressed_ETC2_EAC(format) ||
-            FormatIsCompressed_PVRTC(format));
-}
-
-// Return true if format is a depth or stencil format
-VK_LAYER_EXPORT bool FormatIsDepthOrStencil(VkFormat format) {
-    return (FormatIsDepthAndStencil(format) || FormatIsDepthOnly(format) || FormatIsStencilOnly(format));
-}
-
 // Return true if format contains depth and stencil information
-VK_LAYER_EXPORT bool FormatIsDepthAndStencil(VkFormat format) {
+static bool ComputeFormatIsDepthAndStencil(VkFormat format) {
     bool is_ds = false;
 
     switch (format) {
@@ -378,11 +367,8 @@ VK_LAYER_EXPORT bool FormatIsDepthAndStencil(VkFormat format) {
     return is_ds;
 }
 
-// Return true if format is a stencil-only format
-VK_LAYER_EXPORT bool FormatIsStencilOnly(VkFormat format) { return (format == VK_FORMAT_S8_UINT); }
-
 // Return true if format is a depth-only format
-VK_LAYER_EXPORT bool FormatIsDepthOnly(VkFormat format) {
+static bool ComputeFormatIsDepthOnly(VkFormat format) {
     bool is_depth = false;
 
     switch (format) {
@@ -399,7 +385,7 @@ VK_LAYER_EXPORT bool FormatIsDepthOnly(VkFormat format) {
 }
 
 // Return true if format is of type NORM
-VK_LAYER_EXPORT bool FormatIsNorm(VkFormat format) {
+static bool ComputeFormatIsNorm(VkFormat format) {
     bool is_norm = false;
 
     switch (format) {
@@ -474,7 +460,7 @@ VK_LAYER_EXPORT bool FormatIsNorm(VkFormat format) {
 };
 
 // Return true if format is of type UNORM
-VK_LAYER_EXPORT bool FormatIsUNorm(VkFormat format) {
+static bool ComputeFormatIsUNorm(VkFormat format) {
     bool is_unorm = false;
 
     switch (format) {
@@ -532,7 +518,7 @@ VK_LAYER_EXPORT bool FormatIsUNorm(VkFormat format) {
 };
 
 // Return true if format is of type SNORM
-VK_LAYER_EXPORT bool FormatIsSNorm(VkFormat format) {
+static bool ComputeFormatIsSNorm(VkFormat format) {
     bool is_snorm = false;
 
     switch (format) {
@@ -562,11 +548,8 @@ VK_LAYER_EXPORT bool FormatIsSNorm(VkFormat format) {
     return is_snorm;
 };
 
-// Return true if format is an integer format
-VK_LAYER_EXPORT bool FormatIsInt(VkFormat format) { return (FormatIsSInt(format) || FormatIsUInt(format)); }
-
 // Return true if format is an unsigned integer format
-VK_LAYER_EXPORT bool FormatIsUInt(VkFormat format) {
+static bool ComputeFormatIsUInt(VkFormat format) {
     bool is_uint = false;
 
     switch (format) {
@@ -602,7 +585,7 @@ VK_LAYER_EXPORT bool FormatIsUInt(VkFormat format) {
 }
 
 // Return true if format is a signed integer format
-VK_LAYER_EXPORT bool FormatIsSInt(VkFormat format) {
+static bool ComputeFormatIsSInt(VkFormat format) {
     bool is_sint = false;
 
     switch (format) {
@@ -637,7 +620,7 @@ VK_LAYER_EXPORT bool FormatIsSInt(VkFormat format) {
 }
 
 // Return true if format is a floating-point format
-VK_LAYER_EXPORT bool FormatIsFloat(VkFormat format) {
+static bool ComputeFormatIsFloat(VkFormat format) {
     bool is_float = false;
 
     switch (format) {
@@ -667,7 +650,7 @@ VK_LAYER_EXPORT bool FormatIsFloat(VkFormat format) {
 }
 
 // Return true if format is in the SRGB colorspace
-VK_LAYER_EXPORT bool FormatIsSRGB(VkFormat format) {
+static bool ComputeFormatIsSRGB(VkFormat format) {
     bool is_srgb = false;
 
     switch (format) {
@@ -709,7 +692,7 @@ VK_LAYER_EXPORT bool FormatIsSRGB(VkFormat format) {
 }
 
 // Return true if format is a USCALED format
-VK_LAYER_EXPORT bool FormatIsUScaled(VkFormat format) {
+static bool ComputeFormatIsUScaled(VkFormat format) {
     bool is_uscaled = false;
 
     switch (format) {
@@ -736,7 +719,7 @@ VK_LAYER_EXPORT bool FormatIsUScaled(VkFormat format) {
 }
 
 // Return true if format is a SSCALED format
-VK_LAYER_EXPORT bool FormatIsSScaled(VkFormat format) {
+static bool ComputeFormatIsSScaled(VkFormat format) {
     bool is_sscaled = false;
 
     switch (format) {
@@ -763,7 +746,7 @@ VK_LAYER_EXPORT bool FormatIsSScaled(VkFormat format) {
 }
 
 // Return compressed texel block sizes for block compressed formats
-VK_LAYER_EXPORT VkExtent3D FormatCompressedTexelBlockExtent(VkFormat format) {
+static VkExtent3D ComputeFormatCompressedTexelBlockExtent(VkFormat format) {
     VkExtent3D block_size = {1, 1, 1};
     switch (format) {
         case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
@@ -866,31 +849,228 @@ VK_LAYER_EXPORT VkExtent3D FormatCompressedTexelBlockExtent(VkFormat format) {
     return block_size;
 }
 
+// Per-format properties gathered from vk_format_table and the classification switches above, so that every exported
+// query below is a single indexed load rather than a map lookup or a switch
+enum FormatTableFlagBits {
+    FORMAT_TABLE_COMPRESSED_ETC2_EAC_BIT = 0x00000001,
+    FORMAT_TABLE_COMPRESSED_ASTC_LDR_BIT = 0x00000002,
+    FORMAT_TABLE_COMPRESSED_BC_BIT = 0x00000004,
+    FORMAT_TABLE_COMPRESSED_PVRTC_BIT = 0x00000008,
+    FORMAT_TABLE_DEPTH_AND_STENCIL_BIT = 0x00000010,
+    FORMAT_TABLE_DEPTH_ONLY_BIT = 0x00000020,
+    FORMAT_TABLE_STENCIL_ONLY_BIT = 0x00000040,
+    FORMAT_TABLE_NORM_BIT = 0x00000080,
+    FORMAT_TABLE_UNORM_BIT = 0x00000100,
+    FORMAT_TABLE_SNORM_BIT = 0x00000200,
+    FORMAT_TABLE_UINT_BIT = 0x00000400,
+    FORMAT_TABLE_SINT_BIT = 0x00000800,
+    FORMAT_TABLE_FLOAT_BIT = 0x00001000,
+    FORMAT_TABLE_SRGB_BIT = 0x00002000,
+    FORMAT_TABLE_USCALED_BIT = 0x00004000,
+    FORMAT_TABLE_SSCALED_BIT = 0x00008000,
+};
+
+static const uint32_t FORMAT_TABLE_COMPRESSED_BITS = FORMAT_TABLE_COMPRESSED_ETC2_EAC_BIT | FORMAT_TABLE_COMPRESSED_ASTC_LDR_BIT |
+                                                     FORMAT_TABLE_COMPRESSED_BC_BIT | FORMAT_TABLE_COMPRESSED_PVRTC_BIT;
+static const uint32_t FORMAT_TABLE_DEPTH_OR_STENCIL_BITS =
+    FORMAT_TABLE_DEPTH_AND_STENCIL_BIT | FORMAT_TABLE_DEPTH_ONLY_BIT | FORMAT_TABLE_STENCIL_ONLY_BIT;
+
+struct VULKAN_FORMAT_TABLE_ENTRY {
+    uint32_t flags;
+    uint32_t size;
+    uint32_t channel_count;
+    VkFormatCompatibilityClass format_class;
+    VkExtent3D block_extent;
+};
+
+// Core formats are indexed directly by their enum value; the few extension formats live in a small side table
+class VulkanFormatTable {
+   public:
+    VulkanFormatTable() {
+        unknown_ = {0, 0, 0, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT, {1, 1, 1}};
+        for (uint32_t index = 0; index < VK_FORMAT_RANGE_SIZE; ++index) {
+            core_[index] = Build(static_cast<VkFormat>(VK_FORMAT_BEGIN_RANGE + index));
+        }
+        for (const auto &item : vk_format_table) {
+            if (!IsCoreFormat(item.first)) {
+                extension_.push_back(std::make_pair(item.first, Build(item.first)));
+            }
+        }
+    }
+
+    const VULKAN_FORMAT_TABLE_ENTRY &Get(VkFormat format) const {
+        if (IsCoreFormat(format)) {
+            return core_[static_cast<uint32_t>(format) - VK_FORMAT_BEGIN_RANGE];
+        }
+        for (const auto &item : extension_) {
+            if (item.first == format) return item.second;
+        }
+        return unknown_;
+    }
+
+   private:
+    static bool IsCoreFormat(VkFormat format) {
+        return (static_cast<uint32_t>(format) - VK_FORMAT_BEGIN_RANGE) < static_cast<uint32_t>(VK_FORMAT_RANGE_SIZE);
+    }
+
+    static VULKAN_FORMAT_TABLE_ENTRY Build(VkFormat format) {
+        VULKAN_FORMAT_TABLE_ENTRY entry = {0, 0, 0, VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT, {1, 1, 1}};
+        auto item = vk_format_table.find(format);
+        if (item != vk_format_table.end()) {
+            entry.size = static_cast<uint32_t>(item->second.size);
+            entry.channel_count = item->second.channel_count;
+            entry.format_class = item->second.format_class;
+        }
+        entry.block_extent = ComputeFormatCompressedTexelBlockExtent(format);
+        if (ComputeFormatIsCompressed_ETC2_EAC(format)) entry.flags |= FORMAT_TABLE_COMPRESSED_ETC2_EAC_BIT;
+        if (ComputeFormatIsCompressed_ASTC_LDR(format)) entry.flags |= FORMAT_TABLE_COMPRESSED_ASTC_LDR_BIT;
+        if (ComputeFormatIsCompressed_BC(format)) entry.flags |= FORMAT_TABLE_COMPRESSED_BC_BIT;
+        if (ComputeFormatIsCompressed_PVRTC(format)) entry.flags |= FORMAT_TABLE_COMPRESSED_PVRTC_BIT;
+        if (ComputeFormatIsDepthAndStencil(format)) entry.flags |= FORMAT_TABLE_DEPTH_AND_STENCIL_BIT;
+        if (ComputeFormatIsDepthOnly(format)) entry.flags |= FORMAT_TABLE_DEPTH_ONLY_BIT;
+        if (format == VK_FORMAT_S8_UINT) entry.flags |= FORMAT_TABLE_STENCIL_ONLY_BIT;
+        if (ComputeFormatIsNorm(format)) entry.flags |= FORMAT_TABLE_NORM_BIT;
+        if (ComputeFormatIsUNorm(format)) entry.flags |= FORMAT_TABLE_UNORM_BIT;
+        if (ComputeFormatIsSNorm(format)) entry.flags |= FORMAT_TABLE_SNORM_BIT;
+        if (ComputeFormatIsUInt(format)) entry.flags |= FORMAT_TABLE_UINT_BIT;
+        if (ComputeFormatIsSInt(format)) entry.flags |= FORMAT_TABLE_SINT_BIT;
+        if (ComputeFormatIsFloat(format)) entry.flags |= FORMAT_TABLE_FLOAT_BIT;
+        if (ComputeFormatIsSRGB(format)) entry.flags |= FORMAT_TABLE_SRGB_BIT;
+        if (ComputeFormatIsUScaled(format)) entry.flags |= FORMAT_TABLE_USCALED_BIT;
+        if (ComputeFormatIsSScaled(format)) entry.flags |= FORMAT_TABLE_SSCALED_BIT;
+        return entry;
+    }
+
+    VULKAN_FORMAT_TABLE_ENTRY core_[VK_FORMAT_RANGE_SIZE];
+    std::vector<std::pair<VkFormat, VULKAN_FORMAT_TABLE_ENTRY>> extension_;
+    VULKAN_FORMAT_TABLE_ENTRY unknown_;
+};
+
+static const VulkanFormatTable vk_format_dense_table;
+
+static inline bool FormatHasFlags(VkFormat format, uint32_t flags) {
+    return (vk_format_dense_table.Get(format).flags & flags) != 0;
+}
+
+// Return true if format is an ETC2 or EAC compressed texture format
+VK_LAYER_EXPORT bool FormatIsCompressed_ETC2_EAC(VkFormat format) {
+    return FormatHasFlags(format, FORMAT_TABLE_COMPRESSED_ETC2_EAC_BIT);
+}
+
+// Return true if format is an ASTC compressed texture format
+VK_LAYER_EXPORT bool FormatIsCompressed_ASTC_LDR(VkFormat format) {
+    return FormatHasFlags(format, FORMAT_TABLE_COMPRESSED_ASTC_LDR_BIT);
+}
+
+// Return true if format is a BC compressed texture format
+VK_LAYER_EXPORT bool FormatIsCompressed_BC(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_COMPRESSED_BC_BIT); }
+
+// Return true if format is a PVRTC compressed texture format
+VK_LAYER_EXPORT bool FormatIsCompressed_PVRTC(VkFormat format) {
+    return FormatHasFlags(format, FORMAT_TABLE_COMPRESSED_PVRTC_BIT);
+}
+
+// Return true if format is compressed
+VK_LAYER_EXPORT bool FormatIsCompressed(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_COMPRESSED_BITS); }
+
+// Return true if format is a depth or stencil format
+VK_LAYER_EXPORT bool FormatIsDepthOrStencil(VkFormat format) {
+    return FormatHasFlags(format, FORMAT_TABLE_DEPTH_OR_STENCIL_BITS);
+}
+
+// Return true if format contains depth and stencil information
+VK_LAYER_EXPORT bool FormatIsDepthAndStencil(VkFormat format) {
+    return FormatHasFlags(format, FORMAT_TABLE_DEPTH_AND_STENCIL_BIT);
+}
+
+// Return true if format is a stencil-only format
+VK_LAYER_EXPORT bool FormatIsStencilOnly(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_STENCIL_ONLY_BIT); }
+
+// Return true if format is a depth-only format
+VK_LAYER_EXPORT bool FormatIsDepthOnly(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_DEPTH_ONLY_BIT); }
+
+// Return true if format is of type NORM
+VK_LAYER_EXPORT bool FormatIsNorm(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_NORM_BIT); }
+
+// Return true if format is of type UNORM
+VK_LAYER_EXPORT bool FormatIsUNorm(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_UNORM_BIT); }
+
+// Return true if format is of type SNORM
+VK_LAYER_EXPORT bool FormatIsSNorm(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_SNORM_BIT); }
+
+// Return true if format is an integer format
+VK_LAYER_EXPORT bool FormatIsInt(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_UINT_BIT | FORMAT_TABLE_SINT_BIT); }
+
+// Return true if format is an unsigned integer format
+VK_LAYER_EXPORT bool FormatIsUInt(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_UINT_BIT); }
+
+// Return true if format is a signed integer format
+VK_LAYER_EXPORT bool FormatIsSInt(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_SINT_BIT); }
+
+// Return true if format is a floating-point format
+VK_LAYER_EXPORT bool FormatIsFloat(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_FLOAT_BIT); }
+
+// Return true if format is in the SRGB colorspace
+VK_LAYER_EXPORT bool FormatIsSRGB(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_SRGB_BIT); }
+
+// Return true if format is a USCALED format
+VK_LAYER_EXPORT bool FormatIsUScaled(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_USCALED_BIT); }
+
+// Return true if format is a SSCALED format
+VK_LAYER_EXPORT bool FormatIsSScaled(VkFormat format) { return FormatHasFlags(format, FORMAT_TABLE_SSCALED_BIT); }
+
+// Return compressed texel block sizes for block compressed formats
+VK_LAYER_EXPORT VkExtent3D FormatCompressedTexelBlockExtent(VkFormat format) {
+    return vk_format_dense_table.Get(format).block_extent;
+}
+
 // Return format class of the specified format
 VK_LAYER_EXPORT VkFormatCompatibilityClass FormatCompatibilityClass(VkFormat format) {
-    auto item = vk_format_table.find(format);
-    if (item != vk_format_table.end()) {
-        return item->second.format_class;
-    }
-    return VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT;
+    return vk_format_dense_table.Get(format).format_class;
 }
 
 // Return size, in bytes, of a pixel of the specified format
-VK_LAYER_EXPORT size_t FormatSize(VkFormat format) {
-    auto item = vk_format_table.find(format);
-    if (item != vk_format_table.end()) {
-        return item->second.size;
-    }
-    return 0;
-}
+VK_LAYER_EXPORT size_t FormatSize(VkFormat format) { return vk_format_dense_table.Get(format).size; }
 
 // Return the number of channels for a given format
-unsigned int FormatChannelCount(VkFormat format) {
+unsigned int FormatChannelCount(VkFormat format) { return vk_format_dense_table.Get(format).channel_count; }
+
+// Return true if every table-backed query above answers format the same way as the classification switches and
+// vk_format_table lookups they replaced. Only used by the tests.
+VK_LAYER_EXPORT bool FormatTableMatchesReference(VkFormat format) {
+    size_t size = 0;
+    unsigned int channel_count = 0;
+    VkFormatCompatibilityClass format_class = VK_FORMAT_COMPATIBILITY_CLASS_NONE_BIT;
     auto item = vk_format_table.find(format);
     if (item != vk_format_table.end()) {
-        return item->second.channel_count;
+        size = item->second.size;
+        channel_count = item->second.channel_count;
+        format_class = item->second.format_class;
     }
-    return 0;
+    const bool is_stencil_only = (format == VK_FORMAT_S8_UINT);
+    const VkExtent3D block_extent = ComputeFormatCompressedTexelBlockExtent(format);
+    const VkExtent3D table_block_extent = FormatCompressedTexelBlockExtent(format);
+
+    return FormatSize(format) == size && FormatChannelCount(format) == channel_count &&
+           FormatCompatibilityClass(format) == format_class && table_block_extent.width == block_extent.width &&
+           table_block_extent.height == block_extent.height && table_block_extent.depth == block_extent.depth &&
+           FormatIsCompressed_ETC2_EAC(format) == ComputeFormatIsCompressed_ETC2_EAC(format) &&
+           FormatIsCompressed_ASTC_LDR(format) == ComputeFormatIsCompressed_ASTC_LDR(format) &&
+           FormatIsCompressed_BC(format) == ComputeFormatIsCompressed_BC(format) &&
+           FormatIsCompressed_PVRTC(format) == ComputeFormatIsCompressed_PVRTC(format) &&
+           FormatIsCompressed(format) ==
+               (ComputeFormatIsCompressed_ASTC_LDR(format) || ComputeFormatIsCompressed_BC(format) ||
+                ComputeFormatIsCompressed_ETC2_EAC(format) || ComputeFormatIsCompressed_PVRTC(format)) &&
+           FormatIsDepthAndStencil(format) == ComputeFormatIsDepthAndStencil(format) &&
+           FormatIsDepthOnly(format) == ComputeFormatIsDepthOnly(format) && FormatIsStencilOnly(format) == is_stencil_only &&
+           FormatIsDepthOrStencil(format) ==
+               (ComputeFormatIsDepthAndStencil(format) || ComputeFormatIsDepthOnly(format) || is_stencil_only) &&
+           FormatIsNorm(format) == ComputeFormatIsNorm(format) && FormatIsUNorm(format) == ComputeFormatIsUNorm(format) &&
+           FormatIsSNorm(format) == ComputeFormatIsSNorm(format) && FormatIsUInt(format) == ComputeFormatIsUInt(format) &&
+           FormatIsSInt(format) == ComputeFormatIsSInt(format) &&
+           FormatIsInt(format) == (ComputeFormatIsSInt(format) || ComputeFormatIsUInt(format)) &&
+           FormatIsFloat(format) == ComputeFormatIsFloat(format) && FormatIsSRGB(format) == ComputeFormatIsSRGB(format) &&
+           FormatIsUScaled(format) == ComputeFormatIsUScaled(format) && FormatIsSScaled(format) == ComputeFormatIsSScaled(format);
 }
 
 // Perform a zero-tolerant modulo operation
@@ -121,6 +121,7 @@ VK_LAYER_EXPORT size_t FormatSize(VkFormat format);
 VK_LAYER_EXPORT unsigned int FormatChannelCount(VkFormat format);
 VK_LAYER_EXPORT VkFormatCompatibilityClass FormatCompatibilityClass(VkFormat format);
 VK_LAYER_EXPORT VkDeviceSize SafeModulo(VkDeviceSize dividend, VkDeviceSize divisor);
+VK_LAYER_EXPORT bool FormatTableMatchesReference(VkFormat format);
 
 #ifdef __cplusplus
 }
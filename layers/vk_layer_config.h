@@ -36,6 +36,7 @@ typedef enum VkLayerDbgActionBits {
     VK_DBG_LAYER_ACTION_LOG_MSG = 0x00000002,
     VK_DBG_LAYER_ACTION_BREAK = 0x00000004,
     VK_DBG_LAYER_ACTION_DEBUG_OUTPUT = 0x00000008,
+    VK_DBG_LAYER_ACTION_LOG_MSG_ASYNC = 0x00000010,
     VK_DBG_LAYER_ACTION_DEFAULT = 0x40000000,
 } VkLayerDbgActionBits;
 typedef VkFlags VkLayerDbgActionFlags;
@@ -44,6 +45,7 @@ const std::unordered_map<std::string, VkFlags> debug_actions_option_definitions
     {std::string("VK_DBG_LAYER_ACTION_IGNORE"), VK_DBG_LAYER_ACTION_IGNORE},
     {std::string("VK_DBG_LAYER_ACTION_CALLBACK"), VK_DBG_LAYER_ACTION_CALLBACK},
     {std::string("VK_DBG_LAYER_ACTION_LOG_MSG"), VK_DBG_LAYER_ACTION_LOG_MSG},
+    {std::string("VK_DBG_LAYER_ACTION_LOG_MSG_ASYNC"), VK_DBG_LAYER_ACTION_LOG_MSG_ASYNC},
     {std::string("VK_DBG_LAYER_ACTION_BREAK"), VK_DBG_LAYER_ACTION_BREAK},
 #if defined(WIN32)
     {std::string("VK_DBG_LAYER_ACTION_DEBUG_OUTPUT"), VK_DBG_LAYER_ACTION_DEBUG_OUTPUT},
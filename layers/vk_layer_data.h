@@ -20,7 +20,9 @@
 #ifndef LAYER_DATA_H
 #define LAYER_DATA_H
 
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <unordered_map>
 #include "vk_layer_table.h"
 
@@ -52,4 +54,89 @@ void FreeLayerDataPtr(void *data_key, std::unordered_map<void *, DATA_T *> &laye
     layer_data_map.erase(got);
 }
 
+// Dispatch key to layer_data map used by the layers. Lookups are made at the top of every intercepted call, and an
+// instance rarely has more than one or two devices, so the first few keys live in a small inline array that is searched
+// without locking or hashing. Slots are published with a release store of the key once the value is in place; keys
+// beyond the inline slots fall back to a mutex-guarded unordered_map. Creation and removal are serialized by the same
+// mutex. Callers must not look up a key concurrently with its removal, which the Vulkan threading rules already forbid
+// for the instance or device that owns it.
+template <typename DATA_T>
+class LayerDataMap {
+   public:
+    LayerDataMap() {
+        for (uint32_t i = 0; i < kInlineSlots; ++i) {
+            keys_[i].store(nullptr, std::memory_order_relaxed);
+            values_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+    // Return the data for data_key, creating it on first use
+    DATA_T *Get(void *data_key) {
+        for (uint32_t i = 0; i < kInlineSlots; ++i) {
+            if (keys_[i].load(std::memory_order_acquire) == data_key) {
+                return values_[i].load(std::memory_order_relaxed);
+            }
+        }
+        return GetSlow(data_key);
+    }
+
+    void Free(void *data_key) {
+        std::lock_guard<std::mutex> lock(lock_);
+        for (uint32_t i = 0; i < kInlineSlots; ++i) {
+            if (keys_[i].load(std::memory_order_relaxed) == data_key) {
+                keys_[i].store(nullptr, std::memory_order_release);
+                delete values_[i].exchange(nullptr, std::memory_order_relaxed);
+                return;
+            }
+        }
+        auto got = overflow_.find(data_key);
+        assert(got != overflow_.end());
+        delete got->second;
+        overflow_.erase(got);
+    }
+
+   private:
+    static const uint32_t kInlineSlots = 4;
+
+    DATA_T *GetSlow(void *data_key) {
+        std::lock_guard<std::mutex> lock(lock_);
+        // Another thread may have published the key while we waited for the lock
+        int32_t free_slot = -1;
+        for (uint32_t i = 0; i < kInlineSlots; ++i) {
+            void *key = keys_[i].load(std::memory_order_relaxed);
+            if (key == data_key) {
+                return values_[i].load(std::memory_order_relaxed);
+            } else if (!key && free_slot < 0) {
+                free_slot = i;
+            }
+        }
+        auto got = overflow_.find(data_key);
+        if (got != overflow_.end()) {
+            return got->second;
+        }
+        DATA_T *data = new DATA_T;
+        if (free_slot >= 0) {
+            values_[free_slot].store(data, std::memory_order_relaxed);
+            keys_[free_slot].store(data_key, std::memory_order_release);
+        } else {
+            overflow_[data_key] = data;
+        }
+        return data;
+    }
+
+    std::atomic<void *> keys_[kInlineSlots];
+    std::atomic<DATA_T *> values_[kInlineSlots];
+    std::unordered_map<void *, DATA_T *> overflow_;
+    std::mutex lock_;
+};
+
+template <typename DATA_T>
+DATA_T *GetLayerDataPtr(void *data_key, LayerDataMap<DATA_T> &layer_data_map) {
+    return layer_data_map.Get(data_key);
+}
+
+template <typename DATA_T>
+void FreeLayerDataPtr(void *data_key, LayerDataMap<DATA_T> &layer_data_map) {
+    layer_data_map.Free(data_key);
+}
+
 #endif  // LAYER_DATA_H
@@ -32,14 +32,95 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+// Suppresses repeats of the same message, keyed on (msgCode, object handle). The first `limit` occurrences of each key
+// are reported, later ones are dropped before their text is formatted, with a summary reported after 2^n * limit
+// duplicates so the log still shows how often the message fired.
+class DuplicateMessageFilter {
+   public:
+    enum Action { kReport, kSuppress, kSummarize };
+
+    explicit DuplicateMessageFilter(uint32_t limit) : limit_(limit) {}
+
+    // Count an occurrence of the message, returning what to do with it. For suppressed messages, bail is set to the value
+    // the callbacks returned for the last reported occurrence, and suppressed to the number dropped so far.
+    Action Count(int32_t msg_code, uint64_t object, bool *bail, uint64_t *suppressed) {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto it = counts_.find(Key{msg_code, object});
+        if (it == counts_.end()) {
+            // Stop tracking new keys once the table is full rather than letting it grow without bound
+            if (counts_.size() >= kMaxKeys) return kReport;
+            it = counts_.insert(std::make_pair(Key{msg_code, object}, Entry{0, false})).first;
+        }
+        Entry &entry = it->second;
+        if (++entry.count <= limit_) return kReport;
+        *bail = entry.bail;
+        *suppressed = entry.count - limit_;
+        uint64_t periods = *suppressed / limit_;
+        return ((*suppressed % limit_) == 0 && (periods & (periods - 1)) == 0) ? kSummarize : kSuppress;
+    }
+
+    // Remember what the callbacks returned for the last reported occurrence of the message
+    void SetBail(int32_t msg_code, uint64_t object, bool bail) {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto it = counts_.find(Key{msg_code, object});
+        if (it != counts_.end()) it->second.bail = bail;
+    }
+
+   private:
+    static const size_t kMaxKeys = 64 * 1024;
+
+    struct Key {
+        int32_t msg_code;
+        uint64_t object;
+        bool operator==(const Key &rhs) const { return msg_code == rhs.msg_code && object == rhs.object; }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const {
+            return std::hash<uint64_t>()(key.object ^ (static_cast<uint64_t>(static_cast<uint32_t>(key.msg_code)) << 32));
+        }
+    };
+    struct Entry {
+        uint64_t count;
+        bool bail;
+    };
+
+    const uint32_t limit_;
+    std::mutex lock_;
+    std::unordered_map<Key, Entry, KeyHash> counts_;
+};
+
+// A message logged while its thread was deferring messages. The text is already formatted, but the message has not been
+// through the duplicate filter or reached any callback yet.
+struct DeferredLogMessage {
+    VkFlags msgFlags;
+    VkDebugReportObjectTypeEXT objectType;
+    uint64_t srcObject;
+    size_t location;
+    int32_t msgCode;
+    std::string layer_prefix;
+    std::string message;
+
+    DeferredLogMessage(VkFlags flags, VkDebugReportObjectTypeEXT object_type, uint64_t object, size_t loc, int32_t code,
+                       const char *prefix, const char *text)
+        : msgFlags(flags), objectType(object_type), srcObject(object), location(loc), msgCode(code), layer_prefix(prefix),
+          message(text) {}
+};
+
+// While set, messages the thread logs are appended here instead of being reported, so that work done on a layer's own
+// threads can have its messages reported on the application's thread (see log_deferred_msgs)
+extern THREAD_LOCAL_DECL VK_LAYER_EXPORT std::vector<DeferredLogMessage> *deferred_log_messages;
+
 typedef struct _debug_report_data {
     VkLayerDbgFunctionNode *debug_callback_list;
     VkLayerDbgFunctionNode *default_debug_callback_list;
     VkFlags active_flags;
     bool g_DEBUG_REPORT;
+    DuplicateMessageFilter *duplicate_filter;
 } debug_report_data;
 
 template debug_report_data *GetLayerDataPtr<debug_report_data>(void *data_key,
@@ -50,6 +131,9 @@ static inline bool debug_report_log_msg(const debug_report_data *debug_data, VkF
                                         VkDebugReportObjectTypeEXT objectType, uint64_t srcObject, size_t location, int32_t msgCode,
                                         const char *pLayerPrefix, const char *pMsg);
 
+// Releases what layer_debug_actions attached to a callback it created, such as an asynchronous log writer
+VK_LAYER_EXPORT void layer_debug_actions_release_callback(const VkLayerDbgFunctionNode *callback_node);
+
 // Add a debug message callback node structure to the specified callback linked list
 static inline void AddDebugMessageCallback(debug_report_data *debug_data, VkLayerDbgFunctionNode **list_head,
                                            VkLayerDbgFunctionNode *new_node) {
@@ -82,6 +166,7 @@ static inline void RemoveDebugMessageCallback(debug_report_data *debug_data, VkL
         prev_callback = cur_callback;
         cur_callback = cur_callback->pNext;
         if (matched) {
+            layer_debug_actions_release_callback(prev_callback);
             free(prev_callback);
         }
     }
@@ -98,6 +183,7 @@ static inline void RemoveAllMessageCallbacks(debug_report_data *debug_data, VkLa
         debug_report_log_msg(debug_data, VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_DEBUG_REPORT_EXT,
                              (uint64_t)current_callback->msgCallback, 0, 0, "DebugReport",
                              "Debug Report callbacks not removed before DestroyInstance");
+        layer_debug_actions_release_callback(current_callback);
         free(current_callback);
         current_callback = prev_callback;
     }
@@ -150,6 +236,7 @@ static inline void layer_debug_report_destroy_instance(debug_report_data *debug_
     if (debug_data) {
         RemoveAllMessageCallbacks(debug_data, &debug_data->default_debug_callback_list);
         RemoveAllMessageCallbacks(debug_data, &debug_data->debug_callback_list);
+        delete debug_data->duplicate_filter;
         free(debug_data);
     }
 }
@@ -337,20 +424,68 @@ static inline bool log_msg(const debug_report_data *debug_data, VkFlags msgFlags
         return false;
     }
 
+    // Drop repeats of the same message before paying for formatting it. Deferred messages are filtered once reported.
+    std::vector<DeferredLogMessage> *deferred = deferred_log_messages;
+    if (debug_data->duplicate_filter && !deferred) {
+        bool bail = false;
+        uint64_t suppressed = 0;
+        switch (debug_data->duplicate_filter->Count(msgCode, srcObject, &bail, &suppressed)) {
+            case DuplicateMessageFilter::kReport:
+                break;
+            case DuplicateMessageFilter::kSummarize: {
+                char summary[128];
+                snprintf(summary, sizeof(summary), "Suppressed %" PRIu64 " duplicates of message code %d for object 0x%" PRIx64 ".",
+                         suppressed, msgCode, srcObject);
+                debug_report_log_msg(debug_data, msgFlags, objectType, srcObject, location, msgCode, pLayerPrefix, summary);
+                return bail;
+            }
+            case DuplicateMessageFilter::kSuppress:
+                return bail;
+        }
+    }
+
+    // Most messages fit on the stack, only fall back to a heap allocation for long ones
+    char stack_str[1024];
+    char *heap_str = nullptr;
+    const char *str = stack_str;
     va_list argptr;
+    va_list argcopy;
     va_start(argptr, format);
-    char *str;
-    if (-1 == vasprintf(&str, format, argptr)) {
-        // On failure, glibc vasprintf leaves str undefined
-        str = nullptr;
+    va_copy(argcopy, argptr);
+    int length = vsnprintf(stack_str, sizeof(stack_str), format, argptr);
+    if ((length < 0) || (length >= static_cast<int>(sizeof(stack_str)))) {
+        if (-1 == vasprintf(&heap_str, format, argcopy)) {
+            // On failure, glibc vasprintf leaves str undefined
+            heap_str = nullptr;
+        }
+        str = heap_str ? heap_str : "Allocation failure";
     }
+    va_end(argcopy);
     va_end(argptr);
-    bool result = debug_report_log_msg(debug_data, msgFlags, objectType, srcObject, location, msgCode, pLayerPrefix,
-                                       str ? str : "Allocation failure");
-    free(str);
+    if (deferred) {
+        deferred->emplace_back(msgFlags, objectType, srcObject, location, msgCode, pLayerPrefix, str);
+        free(heap_str);
+        return false;
+    }
+    bool result = debug_report_log_msg(debug_data, msgFlags, objectType, srcObject, location, msgCode, pLayerPrefix, str);
+    free(heap_str);
+    if (debug_data->duplicate_filter) {
+        debug_data->duplicate_filter->SetBail(msgCode, srcObject, result);
+    }
     return result;
 }
 
+// Report messages that were deferred on another thread, in the order they were logged. Returns true if any of them should
+// cause the API call to be skipped.
+static inline bool log_deferred_msgs(const debug_report_data *debug_data, std::vector<DeferredLogMessage> const &messages) {
+    bool skip = false;
+    for (auto const &msg : messages) {
+        skip |= log_msg(debug_data, msg.msgFlags, msg.objectType, msg.srcObject, msg.location, msg.msgCode,
+                        msg.layer_prefix.c_str(), "%s", msg.message.c_str());
+    }
+    return skip;
+}
+
 static inline VKAPI_ATTR VkBool32 VKAPI_CALL log_callback(VkFlags msgFlags, VkDebugReportObjectTypeEXT objType, uint64_t srcObject,
                                                           size_t location, int32_t msgCode, const char *pLayerPrefix,
                                                           const char *pMsg, void *pUserData) {
@@ -19,8 +19,13 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <map>
 #include "vulkan/vulkan.h"
@@ -73,6 +78,8 @@ VK_LAYER_EXPORT VkStringErrorFlags vk_string_validate(const int max_length, cons
     return result;
 }
 
+THREAD_LOCAL_DECL VK_LAYER_EXPORT std::vector<DeferredLogMessage> *deferred_log_messages = nullptr;
+
 // Utility function for finding a text string in another string
 VK_LAYER_EXPORT bool white_list(const char *item, const char *list) {
     std::string candidate(item);
@@ -80,6 +87,153 @@ VK_LAYER_EXPORT bool white_list(const char *item, const char *list) {
     return (white_list.find(candidate) != std::string::npos);
 }
 
+// Writes log messages to a FILE from a background thread, so that a layer reporting a burst of messages (often while
+// holding its global lock) only pays for a copy into memory rather than for file I/O. Messages are appended to a bounded
+// pending buffer which the writer thread swaps out and writes in batches. When the buffer is full new messages are
+// dropped and counted, and the count is written to the log once there is room again.
+class AsyncLogWriter {
+   public:
+    explicit AsyncLogWriter(FILE *output) : output_(output), stop_(false), dropped_(0) {
+        thread_ = std::thread(&AsyncLogWriter::Run, this);
+    }
+
+    ~AsyncLogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stop_ = true;
+        }
+        condition_.notify_one();
+        thread_.join();
+    }
+
+    FILE *Output() const { return output_; }
+
+    void Write(const char *message, size_t length) {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if (pending_.size() + length > kMaxPendingBytes) {
+                dropped_++;
+                return;
+            }
+            pending_.insert(pending_.end(), message, message + length);
+        }
+        condition_.notify_one();
+    }
+
+   private:
+    static const size_t kMaxPendingBytes = 1024 * 1024;
+
+    void Run() {
+        std::vector<char> batch;
+        std::unique_lock<std::mutex> lock(lock_);
+        while (true) {
+            condition_.wait(lock, [this] { return stop_ || !pending_.empty() || dropped_; });
+            if (stop_) break;
+            batch.swap(pending_);
+            uint64_t dropped = dropped_;
+            dropped_ = 0;
+            lock.unlock();
+            WriteBatch(batch, dropped);
+            batch.clear();
+            lock.lock();
+        }
+        WriteBatch(pending_, dropped_);
+        pending_.clear();
+        dropped_ = 0;
+    }
+
+    void WriteBatch(const std::vector<char> &batch, uint64_t dropped) {
+        if (!batch.empty()) fwrite(batch.data(), 1, batch.size(), output_);
+        if (dropped) fprintf(output_, "Validation log: %" PRIu64 " messages dropped, output could not keep up\n", dropped);
+        fflush(output_);
+    }
+
+    FILE *output_;
+    std::thread thread_;
+    std::mutex lock_;
+    std::condition_variable condition_;
+    std::vector<char> pending_;
+    bool stop_;
+    uint64_t dropped_;
+};
+
+// One writer per output file, shared by the layers and instances using this copy of the utils library. On Windows the
+// library is linked statically into each layer, so every layer there has writers of its own. A writer lives as long as
+// the debug callbacks writing through it: destroying the last one drains its pending messages and joins its thread.
+struct AsyncLogWriterMap {
+    struct Entry {
+        std::unique_ptr<AsyncLogWriter> writer;
+        uint32_t callback_count;
+    };
+    std::mutex lock;
+    std::map<FILE *, Entry> writers;
+#ifdef WIN32
+    // Writers still here belong to instances that were never destroyed. Joining their threads from DllMain at unload
+    // would deadlock on the loader lock, so leave them to process teardown.
+    ~AsyncLogWriterMap() {
+        for (auto &entry : writers) entry.second.writer.release();
+    }
+#endif
+};
+static AsyncLogWriterMap async_log_writers;
+
+static AsyncLogWriter *AcquireAsyncLogWriter(FILE *output) {
+    std::lock_guard<std::mutex> lock(async_log_writers.lock);
+    auto result = async_log_writers.writers.insert(std::make_pair(output, AsyncLogWriterMap::Entry()));
+    AsyncLogWriterMap::Entry &entry = result.first->second;
+    if (result.second) {
+        entry.writer.reset(new AsyncLogWriter(output));
+        entry.callback_count = 0;
+    }
+    entry.callback_count++;
+    return entry.writer.get();
+}
+
+static void ReleaseAsyncLogWriter(AsyncLogWriter *writer) {
+    std::unique_ptr<AsyncLogWriter> retired;
+    {
+        std::lock_guard<std::mutex> lock(async_log_writers.lock);
+        auto it = async_log_writers.writers.find(writer->Output());
+        if (it == async_log_writers.writers.end() || it->second.writer.get() != writer) return;
+        if (--it->second.callback_count) return;
+        retired = std::move(it->second.writer);
+        async_log_writers.writers.erase(it);
+    }
+    // Destroying the writer flushes what it has queued and joins its thread; do that outside the map lock
+    retired.reset();
+}
+
+// Same output as log_callback, but handed off to the AsyncLogWriter passed as pUserData
+static VKAPI_ATTR VkBool32 VKAPI_CALL async_log_callback(VkFlags msgFlags, VkDebugReportObjectTypeEXT objType, uint64_t srcObject,
+                                                         size_t location, int32_t msgCode, const char *pLayerPrefix,
+                                                         const char *pMsg, void *pUserData) {
+    static const char *const message_format = "%s(%s): object: 0x%" PRIx64 " type: %d location: %lu msgCode: %d: %s\n";
+    char msg_flags[30];
+    char stack_str[1024];
+
+    print_msg_flags(msgFlags, msg_flags);
+
+    int length = snprintf(stack_str, sizeof(stack_str), message_format, pLayerPrefix, msg_flags, srcObject, objType,
+                          (unsigned long)location, msgCode, pMsg);
+    if (length < 0) return false;
+    if (length < static_cast<int>(sizeof(stack_str))) {
+        reinterpret_cast<AsyncLogWriter *>(pUserData)->Write(stack_str, length);
+    } else {
+        std::vector<char> heap_str(length + 1);
+        snprintf(heap_str.data(), heap_str.size(), message_format, pLayerPrefix, msg_flags, srcObject, objType,
+                 (unsigned long)location, msgCode, pMsg);
+        reinterpret_cast<AsyncLogWriter *>(pUserData)->Write(heap_str.data(), length);
+    }
+
+    return false;
+}
+
+VK_LAYER_EXPORT void layer_debug_actions_release_callback(const VkLayerDbgFunctionNode *callback_node) {
+    if (callback_node->pfnMsgCallback == async_log_callback) {
+        ReleaseAsyncLogWriter(reinterpret_cast<AsyncLogWriter *>(callback_node->pUserData));
+    }
+}
+
 // Debug callbacks get created in three ways:
 //   o  Application-defined debug callbacks
 //   o  Through settings in a vk_layer_settings.txt file
@@ -98,9 +252,17 @@ VK_LAYER_EXPORT void layer_debug_actions(debug_report_data *report_data, std::ve
     std::string report_flags_key = layer_identifier;
     std::string debug_action_key = layer_identifier;
     std::string log_filename_key = layer_identifier;
+    std::string duplicate_limit_key = layer_identifier;
     report_flags_key.append(".report_flags");
     debug_action_key.append(".debug_action");
     log_filename_key.append(".log_filename");
+    duplicate_limit_key.append(".duplicate_message_limit");
+
+    // Report each (message, object) pair at most duplicate_message_limit times, if set
+    uint32_t duplicate_limit = static_cast<uint32_t>(strtoul(getLayerOption(duplicate_limit_key.c_str()), nullptr, 10));
+    if (duplicate_limit && !report_data->duplicate_filter) {
+        report_data->duplicate_filter = new DuplicateMessageFilter(duplicate_limit);
+    }
 
     // Initialize layer options
     VkDebugReportFlagsEXT report_flags = GetLayerOptionFlags(report_flags_key, report_flags_option_definitions, 0);
@@ -108,15 +270,20 @@ VK_LAYER_EXPORT void layer_debug_actions(debug_report_data *report_data, std::ve
     // Flag as default if these settings are not from a vk_layer_settings.txt file
     bool default_layer_callback = (debug_action & VK_DBG_LAYER_ACTION_DEFAULT) ? true : false;
 
-    if (debug_action & VK_DBG_LAYER_ACTION_LOG_MSG) {
+    if (debug_action & (VK_DBG_LAYER_ACTION_LOG_MSG | VK_DBG_LAYER_ACTION_LOG_MSG_ASYNC)) {
         const char *log_filename = getLayerOption(log_filename_key.c_str());
         FILE *log_output = getLayerLogOutput(log_filename, layer_identifier);
         VkDebugReportCallbackCreateInfoEXT dbgCreateInfo;
         memset(&dbgCreateInfo, 0, sizeof(dbgCreateInfo));
         dbgCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_REPORT_CREATE_INFO_EXT;
         dbgCreateInfo.flags = report_flags;
-        dbgCreateInfo.pfnCallback = log_callback;
-        dbgCreateInfo.pUserData = (void *)log_output;
+        if (debug_action & VK_DBG_LAYER_ACTION_LOG_MSG_ASYNC) {
+            dbgCreateInfo.pfnCallback = async_log_callback;
+            dbgCreateInfo.pUserData = (void *)AcquireAsyncLogWriter(log_output);
+        } else {
+            dbgCreateInfo.pfnCallback = log_callback;
+            dbgCreateInfo.pUserData = (void *)log_output;
+        }
         layer_create_msg_callback(report_data, default_layer_callback, &dbgCreateInfo, pAllocator, &callback);
         logging_callback.push_back(callback);
     }
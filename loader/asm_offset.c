@@ -20,6 +20,7 @@
 
 // This code generates an assembly file which provides offsets to get struct members from assembly code.
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include "loader.h"
 
@@ -18,6 +18,7 @@
  * Author: Jon Ashburn <jon@lunarg.com>
  */
 
+#define _GNU_SOURCE
 #include "vk_loader_platform.h"
 #include "loader.h"
 #if defined(__GNUC__) && !defined(__clang__)
@@ -31,6 +31,7 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stddef.h>
+#include <time.h>
 
 #include <sys/types.h>
 #if defined(_WIN32)
@@ -62,6 +63,9 @@ struct loader_struct loader = {0};
 THREAD_LOCAL_DECL struct loader_instance *tls_instance;
 
 static size_t loader_platform_combine_path(char *dest, size_t len, ...);
+static VkResult loader_add_scanned_icd_instance_extensions(const struct loader_instance *inst,
+                                                           struct loader_scanned_icd *scanned_icd,
+                                                           struct loader_extension_list *ext_list);
 
 struct loader_phys_dev_per_icd {
     uint32_t count;
@@ -85,6 +89,7 @@ uint32_t g_loader_log_msgs = 0;
 // additionally CreateDevice and DestroyDevice needs to be locked
 loader_platform_thread_mutex loader_lock;
 loader_platform_thread_mutex loader_json_lock;
+static loader_platform_thread_mutex loader_icd_ext_cache_lock;
 
 LOADER_PLATFORM_THREAD_ONCE_DECLARATION(once_init);
 
@@ -1240,9 +1245,11 @@ VkResult loader_get_icd_loader_instance_extensions(const struct loader_instance
         if (VK_SUCCESS != res) {
             goto out;
         }
-        res = loader_add_instance_extensions(inst, icd_tramp_list->scanned_list[i].EnumerateInstanceExtensionProperties,
-                                             icd_tramp_list->scanned_list[i].lib_name, &icd_exts);
-        if (VK_SUCCESS == res) {
+        res = loader_add_scanned_icd_instance_extensions(inst, &icd_tramp_list->scanned_list[i], &icd_exts);
+        if (VK_ERROR_INCOMPATIBLE_DRIVER == res) {
+            // This ICD could not be loaded, leave it out
+            res = VK_SUCCESS;
+        } else if (VK_SUCCESS == res) {
             if (filter_extensions) {
                 // Remove any extensions not recognized by the loader
                 for (int32_t j = 0; j < (int32_t)icd_exts.count; j++) {
@@ -1282,24 +1289,18 @@ out:
 }
 
 struct loader_icd_term *loader_get_icd_and_device(const VkDevice device, struct loader_device **found_dev, uint32_t *icd_index) {
+    // Going through the dispatch pointer rather than the object itself copes with object wrapping by layers
+    struct loader_device *dev = loader_get_device(device);
+
     *found_dev = NULL;
-    for (struct loader_instance *inst = loader.instances; inst; inst = inst->next) {
-        uint32_t index = 0;
-        for (struct loader_icd_term *icd_term = inst->icd_terms; icd_term; icd_term = icd_term->next) {
-            for (struct loader_device *dev = icd_term->logical_device_list; dev; dev = dev->next)
-                // Value comparison of device prevents object wrapping by layers
-                if (loader_get_dispatch(dev->icd_device) == loader_get_dispatch(device) ||
-                    loader_get_dispatch(dev->chain_device) == loader_get_dispatch(device)) {
-                    *found_dev = dev;
-                    if (NULL != icd_index) {
-                        *icd_index = index;
-                    }
-                    return icd_term;
-                }
-            index++;
-        }
+    if (NULL == dev || NULL == dev->icd_term) {
+        return NULL;
     }
-    return NULL;
+    *found_dev = dev;
+    if (NULL != icd_index) {
+        *icd_index = dev->icd_index;
+    }
+    return dev->icd_term;
 }
 
 void loader_destroy_logical_device(const struct loader_instance *inst, struct loader_device *dev,
@@ -1345,6 +1346,11 @@ struct loader_device *loader_create_logical_device(const struct loader_instance
 }
 
 void loader_add_logical_device(const struct loader_instance *inst, struct loader_icd_term *icd_term, struct loader_device *dev) {
+    dev->icd_term = icd_term;
+    dev->icd_index = 0;
+    for (struct loader_icd_term *cur = icd_term->this_instance->icd_terms; cur && cur != icd_term; cur = cur->next) {
+        dev->icd_index++;
+    }
     dev->next = icd_term->logical_device_list;
     icd_term->logical_device_list = dev;
 }
@@ -1450,7 +1456,9 @@ bool loader_get_icd_interface_version(PFN_vkNegotiateLoaderICDInterfaceVersion f
 void loader_scanned_icd_clear(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list) {
     if (0 != icd_tramp_list->capacity) {
         for (uint32_t i = 0; i < icd_tramp_list->count; i++) {
-            loader_platform_close_library(icd_tramp_list->scanned_list[i].handle);
+            if (NULL != icd_tramp_list->scanned_list[i].handle) {
+                loader_platform_close_library(icd_tramp_list->scanned_list[i].handle);
+            }
             loader_instance_heap_free(inst, icd_tramp_list->scanned_list[i].lib_name);
         }
         loader_instance_heap_free(inst, icd_tramp_list->scanned_list);
@@ -1474,24 +1482,90 @@ static VkResult loader_scanned_icd_init(const struct loader_instance *inst, stru
     return err;
 }
 
+// Monotonic time in nanoseconds, used to report how long ICD libraries take to load
+static uint64_t loader_get_time_ns(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * (1000000000.0 / (double)frequency.QuadPart));
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// Record an ICD found by the manifest scan. The library itself is not opened here; see loader_scanned_icd_load.
 static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list,
                                        const char *filename, uint32_t api_version) {
+    struct loader_scanned_icd *new_scanned_icd;
+    VkResult res = VK_SUCCESS;
+
+    // A library named by path that isn't there can be dropped from the manifest data alone
+    if (loader_platform_is_path(filename) && !loader_platform_file_exists(filename)) {
+        loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_scanned_icd_add: ICD library %s does not exist, skip this ICD.",
+                   filename);
+        goto out;
+    }
+
+    // check for enough capacity
+    if ((icd_tramp_list->count * sizeof(struct loader_scanned_icd)) >= icd_tramp_list->capacity) {
+        void *new_ptr = loader_instance_heap_realloc(inst, icd_tramp_list->scanned_list, icd_tramp_list->capacity,
+                                                     icd_tramp_list->capacity * 2, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+        if (NULL == new_ptr) {
+            res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
+                       "loader_scanned_icd_add: Realloc failed on icd library list for ICD %s", filename);
+            goto out;
+        }
+        icd_tramp_list->scanned_list = new_ptr;
+
+        // double capacity
+        icd_tramp_list->capacity *= 2;
+    }
+
+    new_scanned_icd = &(icd_tramp_list->scanned_list[icd_tramp_list->count]);
+    memset(new_scanned_icd, 0, sizeof(*new_scanned_icd));
+    new_scanned_icd->api_version = api_version;
+
+    new_scanned_icd->lib_name = (char *)loader_instance_heap_alloc(inst, strlen(filename) + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+    if (NULL == new_scanned_icd->lib_name) {
+        loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_scanned_icd_add: Out of memory can't add ICD %s", filename);
+        res = VK_ERROR_OUT_OF_HOST_MEMORY;
+        goto out;
+    }
+    strcpy(new_scanned_icd->lib_name, filename);
+    icd_tramp_list->count++;
+
+out:
+
+    return res;
+}
+
+// Open a scanned ICD's library, negotiate its interface version and resolve its global entry points, if that hasn't
+// been tried yet. Returns whether the ICD is usable; an ICD that fails to load is only attempted once.
+bool loader_scanned_icd_load(const struct loader_instance *inst, struct loader_scanned_icd *scanned_icd) {
     loader_platform_dl_handle handle;
     PFN_vkCreateInstance fp_create_inst;
     PFN_vkEnumerateInstanceExtensionProperties fp_get_inst_ext_props;
     PFN_vkGetInstanceProcAddr fp_get_proc_addr;
     PFN_GetPhysicalDeviceProcAddr fp_get_phys_dev_proc_addr = NULL;
     PFN_vkNegotiateLoaderICDInterfaceVersion fp_negotiate_icd_version;
-    struct loader_scanned_icd *new_scanned_icd;
     uint32_t interface_vers;
-    VkResult res = VK_SUCCESS;
+    const char *filename = scanned_icd->lib_name;
+    uint64_t start_time;
+
+    if (scanned_icd->load_attempted) {
+        return NULL != scanned_icd->handle;
+    }
+    scanned_icd->load_attempted = true;
+    start_time = loader_get_time_ns();
 
-    // TODO implement smarter opening/closing of libraries. For now this
-    // function leaves libraries open and the scanned_icd_clear closes them
     handle = loader_platform_open_library(filename);
     if (NULL == handle) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, loader_platform_open_library_error(filename));
-        goto out;
+        return false;
     }
 
     // Get and settle on an ICD interface version
@@ -1499,10 +1573,10 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
 
     if (!loader_get_icd_interface_version(fp_negotiate_icd_version, &interface_vers)) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                   "loader_scanned_icd_add: ICD %s doesn't support interface"
+                   "loader_scanned_icd_load: ICD %s doesn't support interface"
                    " version compatible with loader, skip this ICD.",
                    filename);
-        goto out;
+        goto error;
     }
 
     fp_get_proc_addr = loader_platform_get_proc_address(handle, "vk_icdGetInstanceProcAddr");
@@ -1512,14 +1586,14 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
         fp_get_proc_addr = loader_platform_get_proc_address(handle, "vkGetInstanceProcAddr");
         if (NULL == fp_get_proc_addr) {
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Attempt to retrieve either "
+                       "loader_scanned_icd_load: Attempt to retrieve either "
                        "\'vkGetInstanceProcAddr\' or "
                        "\'vk_icdGetInstanceProcAddr\' from ICD %s failed.",
                        filename);
-            goto out;
+            goto error;
         } else {
             loader_log(inst, VK_DEBUG_REPORT_WARNING_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Using deprecated ICD "
+                       "loader_scanned_icd_load: Using deprecated ICD "
                        "interface of \'vkGetInstanceProcAddr\' instead of "
                        "\'vk_icdGetInstanceProcAddr\' for ICD %s",
                        filename);
@@ -1527,20 +1601,20 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
         fp_create_inst = loader_platform_get_proc_address(handle, "vkCreateInstance");
         if (NULL == fp_create_inst) {
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add:  Failed querying "
+                       "loader_scanned_icd_load:  Failed querying "
                        "\'vkCreateInstance\' via dlsym/loadlibrary for "
                        "ICD %s",
                        filename);
-            goto out;
+            goto error;
         }
         fp_get_inst_ext_props = loader_platform_get_proc_address(handle, "vkEnumerateInstanceExtensionProperties");
         if (NULL == fp_get_inst_ext_props) {
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Could not get \'vkEnumerate"
+                       "loader_scanned_icd_load: Could not get \'vkEnumerate"
                        "InstanceExtensionProperties\' via dlsym/loadlibrary "
                        "for ICD %s",
                        filename);
-            goto out;
+            goto error;
         }
     } else {
         // Use newer interface version 1 or later
@@ -1551,61 +1625,134 @@ static VkResult loader_scanned_icd_add(const struct loader_instance *inst, struc
         fp_create_inst = (PFN_vkCreateInstance)fp_get_proc_addr(NULL, "vkCreateInstance");
         if (NULL == fp_create_inst) {
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Could not get "
+                       "loader_scanned_icd_load: Could not get "
                        "\'vkCreateInstance\' via \'vk_icdGetInstanceProcAddr\'"
                        " for ICD %s",
                        filename);
-            goto out;
+            goto error;
         }
         fp_get_inst_ext_props =
             (PFN_vkEnumerateInstanceExtensionProperties)fp_get_proc_addr(NULL, "vkEnumerateInstanceExtensionProperties");
         if (NULL == fp_get_inst_ext_props) {
             loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Could not get \'vkEnumerate"
+                       "loader_scanned_icd_load: Could not get \'vkEnumerate"
                        "InstanceExtensionProperties\' via "
                        "\'vk_icdGetInstanceProcAddr\' for ICD %s",
                        filename);
-            goto out;
+            goto error;
         }
         fp_get_phys_dev_proc_addr = loader_platform_get_proc_address(handle, "vk_icdGetPhysicalDeviceProcAddr");
     }
 
-    // check for enough capacity
-    if ((icd_tramp_list->count * sizeof(struct loader_scanned_icd)) >= icd_tramp_list->capacity) {
-        void *new_ptr = loader_instance_heap_realloc(inst, icd_tramp_list->scanned_list, icd_tramp_list->capacity,
-                                                     icd_tramp_list->capacity * 2, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-        if (NULL == new_ptr) {
-            res = VK_ERROR_OUT_OF_HOST_MEMORY;
-            loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
-                       "loader_scanned_icd_add: Realloc failed on icd library list for ICD %s", filename);
-            goto out;
-        }
-        icd_tramp_list->scanned_list = new_ptr;
+    scanned_icd->handle = handle;
+    scanned_icd->GetInstanceProcAddr = fp_get_proc_addr;
+    scanned_icd->GetPhysicalDeviceProcAddr = fp_get_phys_dev_proc_addr;
+    scanned_icd->EnumerateInstanceExtensionProperties = fp_get_inst_ext_props;
+    scanned_icd->CreateInstance = fp_create_inst;
+    scanned_icd->interface_version = interface_vers;
 
-        // double capacity
-        icd_tramp_list->capacity *= 2;
+    loader_log(inst, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, 0, "Loaded ICD %s (interface version %d) in %.3f ms", filename,
+               interface_vers, (double)(loader_get_time_ns() - start_time) / 1000000.0);
+    return true;
+
+error:
+    loader_platform_close_library(handle);
+    return false;
+}
+
+// Instance extensions reported by ICD libraries opened earlier in this process, so that repeated extension queries and
+// instance creation don't have to open an ICD again just to ask for its extensions. Entries are keyed by library path
+// and stamped with the library file's stamp, and are allocated with the system allocator since they outlive instances.
+struct loader_icd_ext_cache_entry {
+    char *lib_name;
+    struct loader_platform_file_stamp stamp;
+    uint32_t count;
+    VkExtensionProperties *list;
+};
+
+static struct loader_icd_ext_cache_entry *loader_icd_ext_cache = NULL;
+static uint32_t loader_icd_ext_cache_count = 0;
+static uint32_t loader_icd_ext_cache_capacity = 0;
+
+static struct loader_icd_ext_cache_entry *loader_find_icd_ext_cache_entry(const char *lib_name) {
+    for (uint32_t i = 0; i < loader_icd_ext_cache_count; i++) {
+        if (!strcmp(loader_icd_ext_cache[i].lib_name, lib_name)) {
+            return &loader_icd_ext_cache[i];
+        }
     }
+    return NULL;
+}
 
-    new_scanned_icd = &(icd_tramp_list->scanned_list[icd_tramp_list->count]);
-    new_scanned_icd->handle = handle;
-    new_scanned_icd->api_version = api_version;
-    new_scanned_icd->GetInstanceProcAddr = fp_get_proc_addr;
-    new_scanned_icd->GetPhysicalDeviceProcAddr = fp_get_phys_dev_proc_addr;
-    new_scanned_icd->EnumerateInstanceExtensionProperties = fp_get_inst_ext_props;
-    new_scanned_icd->CreateInstance = fp_create_inst;
-    new_scanned_icd->interface_version = interface_vers;
+static void loader_update_icd_ext_cache(const char *lib_name, const struct loader_platform_file_stamp *stamp, uint32_t count,
+                                        const VkExtensionProperties *list) {
+    struct loader_icd_ext_cache_entry *entry = loader_find_icd_ext_cache_entry(lib_name);
+    VkExtensionProperties *new_list = NULL;
 
-    new_scanned_icd->lib_name = (char *)loader_instance_heap_alloc(inst, strlen(filename) + 1, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
-    if (NULL == new_scanned_icd->lib_name) {
-        loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_scanned_icd_add: Out of memory can't add ICD %s", filename);
-        res = VK_ERROR_OUT_OF_HOST_MEMORY;
-        goto out;
+    if (count > 0) {
+        new_list = malloc(count * sizeof(VkExtensionProperties));
+        if (NULL == new_list) {
+            return;
+        }
+        memcpy(new_list, list, count * sizeof(VkExtensionProperties));
     }
-    strcpy(new_scanned_icd->lib_name, filename);
-    icd_tramp_list->count++;
+    if (NULL == entry) {
+        if (loader_icd_ext_cache_count == loader_icd_ext_cache_capacity) {
+            uint32_t new_capacity = loader_icd_ext_cache_capacity ? loader_icd_ext_cache_capacity * 2 : 8;
+            void *new_ptr = realloc(loader_icd_ext_cache, new_capacity * sizeof(struct loader_icd_ext_cache_entry));
+            if (NULL == new_ptr) {
+                free(new_list);
+                return;
+            }
+            loader_icd_ext_cache = new_ptr;
+            loader_icd_ext_cache_capacity = new_capacity;
+        }
+        entry = &loader_icd_ext_cache[loader_icd_ext_cache_count];
+        entry->lib_name = malloc(strlen(lib_name) + 1);
+        if (NULL == entry->lib_name) {
+            free(new_list);
+            return;
+        }
+        strcpy(entry->lib_name, lib_name);
+        entry->list = NULL;
+        loader_icd_ext_cache_count++;
+    }
+    free(entry->list);
+    entry->stamp = *stamp;
+    entry->count = count;
+    entry->list = new_list;
+}
 
-out:
+// Add a scanned ICD's instance extensions to ext_list, from the cache when the library is unchanged since it was last
+// asked, and otherwise by loading the ICD. Returns VK_ERROR_INCOMPATIBLE_DRIVER if the ICD can't be loaded.
+static VkResult loader_add_scanned_icd_instance_extensions(const struct loader_instance *inst,
+                                                           struct loader_scanned_icd *scanned_icd,
+                                                           struct loader_extension_list *ext_list) {
+    struct loader_platform_file_stamp stamp;
+    bool have_stamp = loader_platform_is_path(scanned_icd->lib_name) &&
+                      loader_platform_get_file_stamp(scanned_icd->lib_name, &stamp);
+    uint32_t first_new = ext_list->count;
+    VkResult res;
+
+    if (have_stamp) {
+        loader_platform_thread_lock_mutex(&loader_icd_ext_cache_lock);
+        struct loader_icd_ext_cache_entry *entry = loader_find_icd_ext_cache_entry(scanned_icd->lib_name);
+        if (NULL != entry && !memcmp(&entry->stamp, &stamp, sizeof(stamp))) {
+            res = loader_add_to_ext_list(inst, ext_list, entry->count, entry->list);
+            loader_platform_thread_unlock_mutex(&loader_icd_ext_cache_lock);
+            return res;
+        }
+        loader_platform_thread_unlock_mutex(&loader_icd_ext_cache_lock);
+    }
 
+    if (!loader_scanned_icd_load(inst, scanned_icd)) {
+        return VK_ERROR_INCOMPATIBLE_DRIVER;
+    }
+    res = loader_add_instance_extensions(inst, scanned_icd->EnumerateInstanceExtensionProperties, scanned_icd->lib_name, ext_list);
+    if (VK_SUCCESS == res && have_stamp) {
+        loader_platform_thread_lock_mutex(&loader_icd_ext_cache_lock);
+        loader_update_icd_ext_cache(scanned_icd->lib_name, &stamp, ext_list->count - first_new, ext_list->list + first_new);
+        loader_platform_thread_unlock_mutex(&loader_icd_ext_cache_lock);
+    }
     return res;
 }
 
@@ -1661,6 +1808,7 @@ void loader_initialize(void) {
     // initialize mutexs
     loader_platform_thread_create_mutex(&loader_lock);
     loader_platform_thread_create_mutex(&loader_json_lock);
+    loader_platform_thread_create_mutex(&loader_icd_ext_cache_lock);
 
     // initialize logging
     loader_debug_init();
@@ -1737,6 +1885,65 @@ static void loader_get_fullpath(const char *file, const char *dirs, size_t out_s
     (void)snprintf(out_fullpath, out_size, "%s", file);
 }
 
+// Manifest files already parsed by this process. Extension queries and vkCreateInstance both scan every layer and ICD
+// manifest, so keeping the parsed trees lets later scans replace the read and parse of an unchanged file with a stat.
+// Entries outlive the instance whose scan created them, so they are allocated with the system allocator rather than the
+// instance's callbacks. The cache is protected by loader_json_lock, which every caller of loader_get_json holds.
+struct loader_json_cache_entry {
+    char *filename;
+    struct loader_platform_file_stamp stamp;
+    cJSON *json;
+};
+
+static struct loader_json_cache_entry *loader_json_cache = NULL;
+static uint32_t loader_json_cache_count = 0;
+static uint32_t loader_json_cache_capacity = 0;
+
+static struct loader_json_cache_entry *loader_find_json_cache_entry(const char *filename) {
+    for (uint32_t i = 0; i < loader_json_cache_count; i++) {
+        if (!strcmp(loader_json_cache[i].filename, filename)) {
+            return &loader_json_cache[i];
+        }
+    }
+    return NULL;
+}
+
+// Copy a parsed manifest into the cache. cJSON allocates through the calling thread's instance, so that is cleared while
+// the cached copy is made or released. Failing to cache is not an error; the file is simply parsed again next time.
+static void loader_update_json_cache(const char *filename, const struct loader_platform_file_stamp *stamp, cJSON *json) {
+    struct loader_instance *saved_instance = tls_instance;
+    struct loader_json_cache_entry *entry = loader_find_json_cache_entry(filename);
+
+    tls_instance = NULL;
+    if (NULL == entry) {
+        if (loader_json_cache_count == loader_json_cache_capacity) {
+            uint32_t new_capacity = loader_json_cache_capacity ? loader_json_cache_capacity * 2 : 16;
+            void *new_ptr = realloc(loader_json_cache, new_capacity * sizeof(struct loader_json_cache_entry));
+            if (NULL == new_ptr) {
+                goto out;
+            }
+            loader_json_cache = new_ptr;
+            loader_json_cache_capacity = new_capacity;
+        }
+        entry = &loader_json_cache[loader_json_cache_count];
+        entry->filename = malloc(strlen(filename) + 1);
+        if (NULL == entry->filename) {
+            goto out;
+        }
+        strcpy(entry->filename, filename);
+        entry->json = NULL;
+        loader_json_cache_count++;
+    }
+    if (NULL != entry->json) {
+        cJSON_Delete(entry->json);
+    }
+    entry->json = cJSON_Duplicate(json, 1);
+    entry->stamp = *stamp;
+
+out:
+    tls_instance = saved_instance;
+}
+
 // Read a JSON file into a buffer.
 //
 // @return -  A pointer to a cJSON object representing the JSON parse tree.
@@ -1746,6 +1953,8 @@ static VkResult loader_get_json(const struct loader_instance *inst, const char *
     char *json_buf;
     size_t len;
     VkResult res = VK_SUCCESS;
+    struct loader_platform_file_stamp stamp;
+    bool have_stamp;
 
     if (NULL == json) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_get_json: Received invalid JSON file");
@@ -1755,6 +1964,24 @@ static VkResult loader_get_json(const struct loader_instance *inst, const char *
 
     *json = NULL;
 
+    // Hand out a copy of the cached tree if the file has not changed since it was parsed
+    have_stamp = loader_platform_get_file_stamp(filename, &stamp);
+    if (have_stamp) {
+        struct loader_json_cache_entry *entry = loader_find_json_cache_entry(filename);
+        if (NULL != entry && NULL != entry->json && !memcmp(&entry->stamp, &stamp, sizeof(stamp))) {
+            *json = cJSON_Duplicate(entry->json, 1);
+            if (*json == NULL) {
+                loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
+                           "loader_get_json: Failed to copy cached JSON file %s, "
+                           "this is usually because something ran out of "
+                           "memory.",
+                           filename);
+                res = VK_ERROR_OUT_OF_HOST_MEMORY;
+            }
+            goto out;
+        }
+    }
+
     file = fopen(filename, "rb");
     if (!file) {
         loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0, "loader_get_json: Failed to open JSON file %s", filename);
@@ -1792,6 +2019,10 @@ static VkResult loader_get_json(const struct loader_instance *inst, const char *
         goto out;
     }
 
+    if (have_stamp) {
+        loader_update_json_cache(filename, &stamp, *json);
+    }
+
 out:
     if (NULL != file) {
         fclose(file);
@@ -3007,6 +3238,19 @@ void loader_init_icd_lib_list() {}
 
 void loader_destroy_icd_lib_list() {}
 
+// Check the api_version from an ICD's manifest against the version the application asked for. A driver that only
+// implements an older major.minor version fails vkCreateInstance with VK_ERROR_INCOMPATIBLE_DRIVER, so it need not be
+// loaded at all. ICDs whose manifest gave no version are always tried.
+static bool loader_icd_supports_api_version(uint32_t icd_api_version, uint32_t app_api_version) {
+    if (0 == app_api_version || 0 == icd_api_version) {
+        return true;
+    }
+    if (VK_VERSION_MAJOR(icd_api_version) != VK_VERSION_MAJOR(app_api_version)) {
+        return VK_VERSION_MAJOR(icd_api_version) > VK_VERSION_MAJOR(app_api_version);
+    }
+    return VK_VERSION_MINOR(icd_api_version) >= VK_VERSION_MINOR(app_api_version);
+}
+
 // Try to find the Vulkan ICD driver(s).
 //
 // This function scans the default system loader path(s) or path
@@ -3212,6 +3456,18 @@ VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_t
                                file_str);
                 }
 
+                // Leave out ICDs that can't create an instance of the version being requested, before they are loaded
+                if (NULL != inst && !loader_icd_supports_api_version(vers, inst->app_api_version)) {
+                    loader_log(inst, VK_DEBUG_REPORT_INFORMATION_BIT_EXT, 0,
+                               "loader_icd_scan: ICD JSON %s has api_version %d.%d, older than the requested %d.%d. "
+                               " Skipping ICD JSON.",
+                               file_str, VK_VERSION_MAJOR(vers), VK_VERSION_MINOR(vers), VK_VERSION_MAJOR(inst->app_api_version),
+                               VK_VERSION_MINOR(inst->app_api_version));
+                    cJSON_Delete(json);
+                    json = NULL;
+                    continue;
+                }
+
                 res = loader_scanned_icd_add(inst, icd_tramp_list, fullpath, vers);
                 if (VK_SUCCESS != res) {
                     loader_log(inst, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
@@ -3943,19 +4199,14 @@ out:
 }
 
 struct loader_instance *loader_get_instance(const VkInstance instance) {
-    // look up the loader_instance in our list by comparing dispatch tables, as
-    // there is no guarantee the instance is still a loader_instance* after any
-    // layers which wrap the instance object.
-    const VkLayerInstanceDispatchTable *disp;
-    struct loader_instance *ptr_instance = NULL;
-    disp = loader_get_instance_layer_dispatch(instance);
-    for (struct loader_instance *inst = loader.instances; inst; inst = inst->next) {
-        if (&inst->disp->layer_inst_disp == disp) {
-            ptr_instance = inst;
-            break;
-        }
+    // Find the loader_instance through its dispatch table, as there is no
+    // guarantee the instance is still a loader_instance* after any layers
+    // which wrap the instance object.
+    const struct loader_instance_dispatch_table *disp = loader_get_instance_dispatch(instance);
+    if (NULL == disp) {
+        return NULL;
     }
-    return ptr_instance;
+    return disp->instance;
 }
 
 static loader_platform_dl_handle loader_open_layer_lib(const struct loader_instance *inst, const char *chain_type,
@@ -4640,6 +4891,10 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
     icd_create_info.ppEnabledExtensionNames = (const char *const *)filtered_extension_names;
 
     for (uint32_t i = 0; i < ptr_instance->icd_tramp_list.count; i++) {
+        // Every ICD gets its own instance, so this is where any ICD not yet needed for its extensions is loaded
+        if (!loader_scanned_icd_load(ptr_instance, &ptr_instance->icd_tramp_list.scanned_list[i])) {
+            continue;
+        }
         icd_term = loader_icd_add(ptr_instance, &ptr_instance->icd_tramp_list.scanned_list[i]);
         if (NULL == icd_term) {
             loader_log(ptr_instance, VK_DEBUG_REPORT_ERROR_BIT_EXT, 0,
@@ -4667,8 +4922,7 @@ VKAPI_ATTR VkResult VKAPI_CALL terminator_CreateInstance(const VkInstanceCreateI
             continue;
         }
 
-        res = loader_add_instance_extensions(ptr_instance, icd_term->scanned_icd->EnumerateInstanceExtensionProperties,
-                                             icd_term->scanned_icd->lib_name, &icd_exts);
+        res = loader_add_scanned_icd_instance_extensions(ptr_instance, &ptr_instance->icd_tramp_list.scanned_list[i], &icd_exts);
         if (VK_SUCCESS != res) {
             loader_destroy_generic_list(ptr_instance, (struct loader_generic_list *)&icd_exts);
             if (VK_ERROR_OUT_OF_HOST_MEMORY == res) {
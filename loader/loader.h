@@ -180,6 +180,10 @@ struct loader_device {
     VkDevice icd_device;    // device object from the icd
     struct loader_physical_device_term *phys_dev_term;
 
+    // The ICD that owns this device and its position in the instance's ICD list, set once the device is added to it
+    struct loader_icd_term *icd_term;
+    uint32_t icd_index;
+
     // List of activated layers.
     //  app_      is the version based on exactly what the application asked for.
     //            This is what must be returned to the application on Enumerate calls.
@@ -221,6 +225,9 @@ struct loader_instance_dispatch_table {
 
     // Physical device functions unknown to the loader
     PFN_PhysDevExt phys_dev_ext[MAX_NUM_UNKNOWN_EXTS];
+
+    // The instance owning this table, so that any instance object, wrapped by layers or not, leads back to it
+    struct loader_instance *instance;
 };
 
 // Per instance structure
@@ -249,6 +256,7 @@ struct loader_instance {
     uint32_t total_icd_count;
     struct loader_icd_term *icd_terms;
     struct loader_icd_tramp_list icd_tramp_list;
+    uint32_t app_api_version;  // apiVersion from the application's VkApplicationInfo, or 0 if none was given
 
     struct loader_dispatch_hash_entry dev_ext_disp_hash[MAX_NUM_UNKNOWN_EXTS];
     struct loader_dispatch_hash_entry phys_dev_ext_disp_hash[MAX_NUM_UNKNOWN_EXTS];
@@ -331,9 +339,12 @@ struct loader_struct {
     struct loader_instance *instances;
 };
 
+// An ICD found by the manifest scan. The library is opened and its entry points resolved by loader_scanned_icd_load the
+// first time the ICD is actually needed, so handle and the function pointers are NULL until then.
 struct loader_scanned_icd {
     char *lib_name;
     loader_platform_dl_handle handle;
+    bool load_attempted;
     uint32_t api_version;
     uint32_t interface_version;
     PFN_vkGetInstanceProcAddr GetInstanceProcAddr;
@@ -357,6 +368,12 @@ static inline struct loader_dev_dispatch_table *loader_get_dev_dispatch(const vo
     return *((struct loader_dev_dispatch_table **)obj);
 }
 
+// Layers keep the loader's dispatch pointer in any device object they wrap, and that table is the first member of its
+// loader_device, so a device-level object leads straight to the loader_device it was created under.
+static inline struct loader_device *loader_get_device(const void *obj) {
+    return (struct loader_device *)loader_get_dev_dispatch(obj);
+}
+
 static inline VkLayerInstanceDispatchTable *loader_get_instance_layer_dispatch(const void *obj) {
     return *((VkLayerInstanceDispatchTable **)obj);
 }
@@ -437,6 +454,7 @@ void loader_find_layer_name_add_list(const struct loader_instance *inst, const c
                                      const struct loader_layer_list *source_list, struct loader_layer_list *target_list,
                                      struct loader_layer_list *expanded_target_list);
 void loader_scanned_icd_clear(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list);
+bool loader_scanned_icd_load(const struct loader_instance *inst, struct loader_scanned_icd *scanned_icd);
 VkResult loader_icd_scan(const struct loader_instance *inst, struct loader_icd_tramp_list *icd_tramp_list);
 void loader_layer_scan(const struct loader_instance *inst, struct loader_layer_list *instance_layers);
 void loader_implicit_layer_scan(const struct loader_instance *inst, struct loader_layer_list *instance_layers);
@@ -24,6 +24,7 @@
 // attempts to accomplish this by relying on tail-call optimizations, but there is no guarantee that this will work. As a result,
 // this code is only compiled on systems where an assembly alternative has not been written.
 
+#define _GNU_SOURCE
  #include "vk_loader_platform.h"
  #include "loader.h"
 
@@ -27,6 +27,7 @@
 // unknown to the loader, it will use this code.  Technically, this is not trampoline
 // code since we don't want to optimize it out.
 
+#define _GNU_SOURCE
 #include "vk_loader_platform.h"
 #include "loader.h"
 
@@ -290,7 +290,10 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         }
     }
 
-    // Scan/discover all ICD libraries
+    // Scan/discover all ICD libraries, leaving out those too old for the requested API version
+    if (NULL != pCreateInfo->pApplicationInfo) {
+        ptr_instance->app_api_version = pCreateInfo->pApplicationInfo->apiVersion;
+    }
     memset(&ptr_instance->icd_tramp_list, 0, sizeof(ptr_instance->icd_tramp_list));
     res = loader_icd_scan(ptr_instance, &ptr_instance->icd_tramp_list);
     if (res != VK_SUCCESS) {
@@ -316,6 +319,7 @@ LOADER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(const VkInstanceCr
         goto out;
     }
     memcpy(&ptr_instance->disp->layer_inst_disp, &instance_disp, sizeof(instance_disp));
+    ptr_instance->disp->instance = ptr_instance;
 
     ptr_instance->next = loader.instances;
     loader.instances = ptr_instance;
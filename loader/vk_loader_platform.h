@@ -30,6 +30,13 @@
 #include "vulkan/vk_platform.h"
 #include "vulkan/vk_sdk_platform.h"
 
+// Identifies one version of a file's contents, so that data derived from the file can be reused while it is unchanged
+struct loader_platform_file_stamp {
+    uint64_t modified;
+    uint64_t size;
+    uint64_t id;
+};
+
 #if defined(__linux__)
 /* Linux-specific common code: */
 
@@ -45,6 +52,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <libgen.h>
+#include <sys/stat.h>
 
 // VK Library Filenames, Paths, etc.:
 #define PATH_SEPARATOR ':'
@@ -93,6 +101,15 @@ static inline bool loader_platform_is_path_absolute(const char *path) {
         return false;
 }
 
+static inline bool loader_platform_get_file_stamp(const char *path, struct loader_platform_file_stamp *stamp) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    stamp->modified = (uint64_t)st.st_mtim.tv_sec * 1000000000ull + (uint64_t)st.st_mtim.tv_nsec;
+    stamp->size = (uint64_t)st.st_size;
+    stamp->id = (uint64_t)st.st_ino;
+    return true;
+}
+
 static inline char *loader_platform_dirname(char *path) { return dirname(path); }
 
 // Dynamic Loading of libraries:
@@ -197,6 +214,15 @@ static bool loader_platform_file_exists(const char *path) {
 
 static bool loader_platform_is_path_absolute(const char *path) { return !PathIsRelative(path); }
 
+static bool loader_platform_get_file_stamp(const char *path, struct loader_platform_file_stamp *stamp) {
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return false;
+    stamp->modified = ((uint64_t)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+    stamp->size = ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    stamp->id = 0;
+    return true;
+}
+
 // WIN32 runtime doesn't have dirname().
 static inline char *loader_platform_dirname(char *path) {
     char *current, *next;
@@ -137,6 +137,7 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
             'vkCreateSwapchainKHR',
             'vkCreateSharedSwapchainsKHR',
             'vkGetSwapchainImagesKHR',
+            'vkDestroySwapchainKHR',
             'vkQueuePresentKHR',
             'vkEnumerateInstanceLayerProperties',
             'vkEnumerateDeviceLayerProperties',
@@ -172,6 +173,12 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
                                        # A sister-struct may contain no handles but shares <validextensionstructs> with one that does
         self.structTypes = dict()      # Map of Vulkan struct typename to required VkStructureType
         self.struct_member_dict = dict()
+        # Struct members only read for some values of a sibling member; the format string takes the struct's prefix
+        self.member_conditions = {
+            ('VkWriteDescriptorSet', 'pImageInfo'): 'DescriptorTypeUsesImageInfo(%sdescriptorType)',
+            ('VkWriteDescriptorSet', 'pBufferInfo'): 'DescriptorTypeUsesBufferInfo(%sdescriptorType)',
+            ('VkWriteDescriptorSet', 'pTexelBufferView'): 'DescriptorTypeUsesTexelBufferView(%sdescriptorType)',
+            }
         # Named tuples to store struct and command data
         self.StructType = namedtuple('StructType', ['name', 'value'])
         self.CmdMemberData = namedtuple('CmdMemberData', ['name', 'members'])
@@ -413,10 +420,6 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
         self.structMembers.append(self.StructMemberData(name=typeName, members=membersInfo))
 
     #
-    # Insert a lock_guard line
-    def lock_guard(self, indent):
-        return '%sstd::lock_guard<std::mutex> lock(global_lock);\n' % indent
-    #
     # Determine if a struct has an NDO as a member or an embedded member
     def struct_contains_ndo(self, struct_item):
         struct_member_dict = dict(self.structMembers)
@@ -481,28 +484,47 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
     #
     # Generate pNext handling function
     def build_extension_processing_func(self):
-        # Construct helper functions to build and free pNext extension chains
+        # Construct helper function to build unwrapped pNext extension chains in a call's scratch memory
         pnext_proc = ''
-        pnext_proc += 'void *CreateUnwrappedExtensionStructs(layer_data *dev_data, const void *pNext) {\n'
-        pnext_proc += '    void *cur_pnext = const_cast<void *>(pNext);\n'
-        pnext_proc += '    void *head_pnext = NULL;\n'
-        pnext_proc += '    void *prev_ext_struct = NULL;\n'
-        pnext_proc += '    void *cur_ext_struct = NULL;\n\n'
-        pnext_proc += '    while (cur_pnext != NULL) {\n'
-        pnext_proc += '        GenericHeader *header = reinterpret_cast<GenericHeader *>(cur_pnext);\n\n'
-        pnext_proc += '        switch (header->sType) {\n'
+        # Sizes of every structure that can appear in a chain, used to copy structures ahead of one that has to be unwrapped
+        pnext_proc += 'static size_t GetExtensionStructSize(VkStructureType sType) {\n'
+        pnext_proc += '    switch (sType) {\n'
+        seen_values = set()
+        for item, struct_type in self.structTypes.items():
+            if struct_type.value in seen_values or item not in self.struct_member_dict:
+                continue
+            seen_values.add(struct_type.value)
+            feature_protect = self.struct_member_dict[item][0].feature_protect
+            if feature_protect is not None:
+                pnext_proc += '#ifdef %s\n' % feature_protect
+            pnext_proc += '        case %s:\n' % struct_type.value
+            pnext_proc += '            return sizeof(%s);\n' % item
+            if feature_protect is not None:
+                pnext_proc += '#endif // %s\n' % feature_protect
+        pnext_proc += '        default:\n'
+        pnext_proc += '            return 0;\n'
+        pnext_proc += '    }\n'
+        pnext_proc += '}\n\n'
+        pnext_proc += 'void *CreateUnwrappedExtensionStructs(layer_data *dev_data, ScratchScope &scratch, const void *pNext) {\n'
+        pnext_proc += '    void *head_pnext = const_cast<void *>(pNext);\n'
+        pnext_proc += '    GenericHeader *prev_ext_struct = NULL;\n'
+        pnext_proc += '    // First of the structures since the last copy that this layer had no reason to copy\n'
+        pnext_proc += '    const GenericHeader *first_uncopied = NULL;\n\n'
+        pnext_proc += '    for (auto cur_pnext = reinterpret_cast<const GenericHeader *>(pNext); cur_pnext != NULL;\n'
+        pnext_proc += '         cur_pnext = reinterpret_cast<const GenericHeader *>(cur_pnext->pNext)) {\n'
+        pnext_proc += '        void *cur_ext_struct = NULL;\n\n'
+        pnext_proc += '        switch (cur_pnext->sType) {\n'
         for item in self.extension_structs:
             struct_info = self.struct_member_dict[item]
             if struct_info[0].feature_protect is not None:
                 pnext_proc += '#ifdef %s \n' % struct_info[0].feature_protect
             pnext_proc += '            case %s: {\n' % self.structTypes[item].value
-            pnext_proc += '                    safe_%s *safe_struct = new safe_%s;\n' % (item, item)
-            pnext_proc += '                    safe_struct->initialize(reinterpret_cast<const %s *>(cur_pnext));\n' % item
+            pnext_proc += '                    %s *ext_struct = scratch.Copy(reinterpret_cast<const %s *>(cur_pnext));\n' % (item, item)
             # Generate code to unwrap the handles
             indent = '                '
-            (tmp_decl, tmp_pre, tmp_post) = self.uniquify_members(struct_info, indent, 'safe_struct->', 0, False, False, False, False)
+            (tmp_decl, tmp_pre, tmp_post) = self.uniquify_members(struct_info, indent, 'ext_struct->', 0, False, False, False, False, item)
             pnext_proc += tmp_pre
-            pnext_proc += '                    cur_ext_struct = reinterpret_cast<void *>(safe_struct);\n'
+            pnext_proc += '                    cur_ext_struct = reinterpret_cast<void *>(ext_struct);\n'
             pnext_proc += '                } break;\n'
             if struct_info[0].feature_protect is not None:
                 pnext_proc += '#endif // %s \n' % struct_info[0].feature_protect
@@ -510,31 +532,54 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
         pnext_proc += '            default:\n'
         pnext_proc += '                break;\n'
         pnext_proc += '        }\n\n'
-        pnext_proc += '        // Save pointer to the first structure in the pNext chain\n'
-        pnext_proc += '        head_pnext = (head_pnext ? head_pnext : cur_ext_struct);\n\n'
-        pnext_proc += '        // For any extension structure but the first, link the last struct\'s pNext to the current ext struct\n'
+        pnext_proc += '        // Structures without handles stay linked as-is; keep walking in case a later one needs unwrapping\n'
+        pnext_proc += '        if (cur_ext_struct == NULL) {\n'
+        pnext_proc += '            if (first_uncopied == NULL) {\n'
+        pnext_proc += '                first_uncopied = cur_pnext;\n'
+        pnext_proc += '            }\n'
+        pnext_proc += '            continue;\n'
+        pnext_proc += '        }\n\n'
+        pnext_proc += '        // The application\'s chain can\'t be written to, so the structures between the last copy and this one are\n'
+        pnext_proc += '        // shallow-copied to link the unwrapped structure in. One of unknown size can\'t be copied and is left out.\n'
+        pnext_proc += '        for (auto uncopied = first_uncopied; uncopied != NULL && uncopied != cur_pnext;\n'
+        pnext_proc += '             uncopied = reinterpret_cast<const GenericHeader *>(uncopied->pNext)) {\n'
+        pnext_proc += '            size_t size = GetExtensionStructSize(uncopied->sType);\n'
+        pnext_proc += '            if (size == 0) {\n'
+        pnext_proc += '                continue;\n'
+        pnext_proc += '            }\n'
+        pnext_proc += '            auto copy = reinterpret_cast<GenericHeader *>(scratch.Alloc<char>(size));\n'
+        pnext_proc += '            memcpy(copy, uncopied, size);\n'
+        pnext_proc += '            if (prev_ext_struct) {\n'
+        pnext_proc += '                prev_ext_struct->pNext = copy;\n'
+        pnext_proc += '            } else {\n'
+        pnext_proc += '                head_pnext = copy;\n'
+        pnext_proc += '            }\n'
+        pnext_proc += '            prev_ext_struct = copy;\n'
+        pnext_proc += '        }\n'
+        pnext_proc += '        first_uncopied = NULL;\n\n'
+        pnext_proc += '        // Link the copy in place of the original. Its own pNext still points at the rest of the original chain.\n'
         pnext_proc += '        if (prev_ext_struct) {\n'
-        pnext_proc += '            (reinterpret_cast<GenericHeader *>(prev_ext_struct))->pNext = cur_ext_struct;\n'
+        pnext_proc += '            prev_ext_struct->pNext = cur_ext_struct;\n'
+        pnext_proc += '        } else {\n'
+        pnext_proc += '            head_pnext = cur_ext_struct;\n'
         pnext_proc += '        }\n'
-        pnext_proc += '        prev_ext_struct = cur_ext_struct;\n\n'
-        pnext_proc += '        // Process the next structure in the chain\n'
-        pnext_proc += '        cur_pnext = const_cast<void *>(header->pNext);\n'
+        pnext_proc += '        prev_ext_struct = reinterpret_cast<GenericHeader *>(cur_ext_struct);\n'
         pnext_proc += '    }\n'
         pnext_proc += '    return head_pnext;\n'
-        pnext_proc += '}\n\n'
-        pnext_proc += '// Free a pNext extension chain\n'
-        pnext_proc += 'void FreeUnwrappedExtensionStructs(void *head) {\n'
-        pnext_proc += '    void * curr_ptr = head;\n'
-        pnext_proc += '    while (curr_ptr) {\n'
-        pnext_proc += '        GenericHeader *header = reinterpret_cast<GenericHeader *>(curr_ptr);\n'
-        pnext_proc += '        void *temp = curr_ptr;\n'
-        pnext_proc += '        curr_ptr = header->pNext;\n'
-        pnext_proc += '        free(temp);\n'
-        pnext_proc += '    }\n'
         pnext_proc += '}\n'
         return pnext_proc
 
     #
+    # Find the command that destroys a single object of handle_type created from parent_type, or None if there is none
+    def find_destroy_command(self, handle_type, parent_type):
+        for cmd_name, cmd_info in self.cmdMembers:
+            if True not in [destroy_txt in cmd_name for destroy_txt in ['Destroy', 'Free']]:
+                continue
+            if len(cmd_info) == 3 and cmd_info[0].type == parent_type and cmd_info[1].type == handle_type and \
+                    cmd_info[1].len is None and cmd_info[2].type == 'VkAllocationCallbacks':
+                return cmd_name
+        return None
+    #
     # Generate source for creating a non-dispatchable object
     def generate_create_ndo_code(self, indent, proto, params, cmd_info):
         create_ndo_code = ''
@@ -547,16 +592,32 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
             handle_name = params[-1].find('name')
             create_ndo_code += '%sif (VK_SUCCESS == result) {\n' % (indent)
             indent = self.incIndent(indent)
-            create_ndo_code += '%sstd::lock_guard<std::mutex> lock(global_lock);\n' % (indent)
-            ndo_dest = '*%s' % handle_name.text
             if ndo_array == True:
+                # If any handle can't be wrapped, the ones that were are retired again so the call fails as a whole
                 create_ndo_code += '%sfor (uint32_t index0 = 0; index0 < %s; index0++) {\n' % (indent, cmd_info[-1].len)
                 indent = self.incIndent(indent)
-                ndo_dest = '%s[index0]' % cmd_info[-1].name
-            create_ndo_code += '%s%s = WrapNew(dev_data, %s);\n' % (indent, ndo_dest, ndo_dest)
-            if ndo_array == True:
+                create_ndo_code += '%s%s[index0] = WrapNew(dev_data, %s[index0]);\n' % (indent, cmd_info[-1].name, cmd_info[-1].name)
+                create_ndo_code += '%sif (%s[index0] == VK_NULL_HANDLE) {\n' % (indent, cmd_info[-1].name)
+                create_ndo_code += '%s    for (uint32_t index1 = 0; index1 < %s; index1++) {\n' % (indent, cmd_info[-1].len)
+                create_ndo_code += '%s        if (index1 < index0) UnwrapAndErase(dev_data, %s[index1]);\n' % (indent, cmd_info[-1].name)
+                create_ndo_code += '%s        %s[index1] = VK_NULL_HANDLE;\n' % (indent, cmd_info[-1].name)
+                create_ndo_code += '%s    }\n' % indent
+                create_ndo_code += '%s    result = VK_ERROR_OUT_OF_HOST_MEMORY;\n' % indent
+                create_ndo_code += '%s    break;\n' % indent
+                create_ndo_code += '%s}\n' % indent
                 indent = self.decIndent(indent)
                 create_ndo_code += '%s}\n' % indent
+            else:
+                ndo_dest = '*%s' % handle_name.text
+                create_ndo_code += '%s%s wrapped_handle = WrapNew(dev_data, %s);\n' % (indent, handle_type.text, ndo_dest)
+                create_ndo_code += '%sif (wrapped_handle == VK_NULL_HANDLE) {\n' % indent
+                # Out of unique ids: release the object if it can be, and fail the call rather than return a null handle
+                destroy_cmd = self.find_destroy_command(handle_type.text, cmd_info[0].type)
+                if destroy_cmd is not None:
+                    create_ndo_code += '%s    dev_data->dispatch_table.%s(%s, %s, pAllocator);\n' % (indent, destroy_cmd[2:], cmd_info[0].name, ndo_dest)
+                create_ndo_code += '%s    result = VK_ERROR_OUT_OF_HOST_MEMORY;\n' % indent
+                create_ndo_code += '%s}\n' % indent
+                create_ndo_code += '%s%s = wrapped_handle;\n' % (indent, ndo_dest)
             indent = self.decIndent(indent)
             create_ndo_code += '%s}\n' % (indent)
         return create_ndo_code
@@ -577,80 +638,50 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
                     # This API is freeing an array of handles.  Remove them from the unique_id map.
                     destroy_ndo_code += '%sif ((VK_SUCCESS == result) && (%s)) {\n' % (indent, cmd_info[param].name)
                     indent = self.incIndent(indent)
-                    destroy_ndo_code += '%sstd::unique_lock<std::mutex> lock(global_lock);\n' % (indent)
                     destroy_ndo_code += '%sfor (uint32_t index0 = 0; index0 < %s; index0++) {\n' % (indent, cmd_info[param].len)
                     indent = self.incIndent(indent)
-                    destroy_ndo_code += '%s%s handle = %s[index0];\n' % (indent, cmd_info[param].type, cmd_info[param].name)
-                    destroy_ndo_code += '%suint64_t unique_id = reinterpret_cast<uint64_t &>(handle);\n' % (indent)
-                    destroy_ndo_code += '%sdev_data->unique_id_mapping.erase(unique_id);\n' % (indent)
+                    destroy_ndo_code += '%sUnwrapAndErase(dev_data, %s[index0]);\n' % (indent, cmd_info[param].name)
                     indent = self.decIndent(indent);
                     destroy_ndo_code += '%s}\n' % indent
                     indent = self.decIndent(indent);
                     destroy_ndo_code += '%s}\n' % indent
                 else:
                     # Remove a single handle from the map
-                    destroy_ndo_code += '%sstd::unique_lock<std::mutex> lock(global_lock);\n' % (indent)
-                    destroy_ndo_code += '%suint64_t %s_id = reinterpret_cast<uint64_t &>(%s);\n' % (indent, cmd_info[param].name, cmd_info[param].name)
-                    destroy_ndo_code += '%s%s = (%s)dev_data->unique_id_mapping[%s_id];\n' % (indent, cmd_info[param].name, cmd_info[param].type, cmd_info[param].name)
-                    destroy_ndo_code += '%sdev_data->unique_id_mapping.erase(%s_id);\n' % (indent, cmd_info[param].name)
-                    destroy_ndo_code += '%slock.unlock();\n' % (indent)
+                    destroy_ndo_code += '%s%s = UnwrapAndErase(dev_data, %s);\n' % (indent, cmd_info[param].name, cmd_info[param].name)
         return ndo_array, destroy_ndo_code
 
     #
-    # Clean up local declarations
-    def cleanUpLocalDeclarations(self, indent, prefix, name, len, index, process_pnext):
-        cleanup = '%sif (local_%s%s) {\n' % (indent, prefix, name)
-        if len is not None:
-            if process_pnext:
-                cleanup += '%s    for (uint32_t %s = 0; %s < %s%s; ++%s) {\n' % (indent, index, index, prefix, len, index)
-                cleanup += '%s        FreeUnwrappedExtensionStructs(const_cast<void *>(local_%s%s[%s].pNext));\n' % (indent, prefix, name, index)
-                cleanup += '%s    }\n' % indent
-            cleanup += '%s    delete[] local_%s%s;\n' % (indent, prefix, name)
-        else:
-            if process_pnext:
-                cleanup += '%s    FreeUnwrappedExtensionStructs(const_cast<void *>(local_%s%s->pNext));\n' % (indent, prefix, name)
-            cleanup += '%s    delete local_%s%s;\n' % (indent, prefix, name)
-        cleanup += "%s}\n" % (indent)
-        return cleanup
-    #
-    # Output UO code for a single NDO (ndo_count is NULL) or a counted list of NDOs
+    # Output UO code for a single NDO (ndo_count is NULL) or a counted list of NDOs. Parameters are unwrapped into copies
+    # allocated from the call's scratch memory; a counted list below the first level is copied and its pointer redirected.
     def outputNDOs(self, ndo_type, ndo_name, ndo_count, prefix, index, indent, destroy_func, destroy_array, top_level):
         decl_code = ''
         pre_call_code = ''
         post_call_code = ''
         if ndo_count is not None:
+            local_name = 'local_%s' % ndo_name
             if top_level == True:
-                decl_code += '%s%s *local_%s%s = NULL;\n' % (indent, ndo_type, prefix, ndo_name)
+                decl_code += '%s%s *%s = NULL;\n' % (indent, ndo_type, local_name)
             pre_call_code += '%s    if (%s%s) {\n' % (indent, prefix, ndo_name)
             indent = self.incIndent(indent)
             if top_level == True:
-                pre_call_code += '%s    local_%s%s = new %s[%s];\n' % (indent, prefix, ndo_name, ndo_type, ndo_count)
-                pre_call_code += '%s    for (uint32_t %s = 0; %s < %s; ++%s) {\n' % (indent, index, index, ndo_count, index)
-                indent = self.incIndent(indent)
-                pre_call_code += '%s    local_%s%s[%s] = Unwrap(dev_data, %s[%s]);\n' % (indent, prefix, ndo_name, index, ndo_name, index)
+                pre_call_code += '%s    %s = scratch.Alloc<%s>(%s);\n' % (indent, local_name, ndo_type, ndo_count)
             else:
-                pre_call_code += '%s    for (uint32_t %s = 0; %s < %s; ++%s) {\n' % (indent, index, index, ndo_count, index)
-                indent = self.incIndent(indent)
-                pre_call_code += '%s    %s%s[%s] = Unwrap(dev_data, %s%s[%s]);\n' % (indent, prefix, ndo_name, index, prefix, ndo_name, index)
-            indent = self.decIndent(indent)
+                pre_call_code += '%s    %s *%s = scratch.Alloc<%s>(%s);\n' % (indent, ndo_type, local_name, ndo_type, ndo_count)
+            pre_call_code += '%s    for (uint32_t %s = 0; %s < %s; ++%s) {\n' % (indent, index, index, ndo_count, index)
+            pre_call_code += '%s        %s[%s] = Unwrap(dev_data, %s%s[%s]);\n' % (indent, local_name, index, prefix, ndo_name, index)
             pre_call_code += '%s    }\n' % indent
+            if top_level == False:
+                pre_call_code += '%s    %s%s = %s;\n' % (indent, prefix, ndo_name, local_name)
             indent = self.decIndent(indent)
             pre_call_code += '%s    }\n' % indent
-            if top_level == True:
-                post_call_code += '%sif (local_%s%s)\n' % (indent, prefix, ndo_name)
-                indent = self.incIndent(indent)
-                post_call_code += '%sdelete[] local_%s;\n' % (indent, ndo_name)
         else:
             if top_level == True:
                 if (destroy_func == False) or (destroy_array == True):
                     pre_call_code += '%s    %s = Unwrap(dev_data, %s);\n' % (indent, ndo_name, ndo_name)
             else:
-                # Make temp copy of this var with the 'local' removed. It may be better to not pass in 'local_'
-                # as part of the string and explicitly print it
-                fix = str(prefix).strip('local_');
-                pre_call_code += '%s    if (%s%s) {\n' % (indent, fix, ndo_name)
+                pre_call_code += '%s    if (%s%s) {\n' % (indent, prefix, ndo_name)
                 indent = self.incIndent(indent)
-                pre_call_code += '%s    %s%s = Unwrap(dev_data, %s%s);\n' % (indent, prefix, ndo_name, fix, ndo_name)
+                pre_call_code += '%s    %s%s = Unwrap(dev_data, %s%s);\n' % (indent, prefix, ndo_name, prefix, ndo_name)
                 indent = self.decIndent(indent)
                 pre_call_code += '%s    }\n' % indent
         return decl_code, pre_call_code, post_call_code
@@ -659,7 +690,8 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
     # create_func means that this is API creates or allocates NDOs
     # destroy_func indicates that this API destroys or frees NDOs
     # destroy_array means that the destroy_func operated on an array of NDOs
-    def uniquify_members(self, members, indent, prefix, array_index, create_func, destroy_func, destroy_array, first_level_param):
+    # struct_type names the struct whose members are being processed, if any
+    def uniquify_members(self, members, indent, prefix, array_index, create_func, destroy_func, destroy_array, first_level_param, struct_type=None):
         decls = ''
         pre_code = ''
         post_code = ''
@@ -667,79 +699,79 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
         array_index += 1
         # Process any NDOs in this structure and recurse for any sub-structs in this struct
         for member in members:
-            process_pnext = self.StructWithExtensions(member.type)
-            # Handle NDOs
-            if self.isHandleTypeNonDispatchable(member.type) == True:
-                count_name = member.len
-                if (count_name is not None):
-                    if first_level_param == False:
-                        count_name = '%s%s' % (prefix, member.len)
+            condition = self.member_conditions.get((struct_type, member.name))
+            if condition is None:
+                (tmp_decl, tmp_pre, tmp_post) = self.uniquify_member(member, indent, prefix, index, array_index, create_func, destroy_func, destroy_array, first_level_param)
+            else:
+                (tmp_decl, tmp_pre, tmp_post) = self.uniquify_member(member, self.incIndent(indent), prefix, index, array_index, create_func, destroy_func, destroy_array, first_level_param)
+                if tmp_pre:
+                    tmp_pre = '%s    if (%s) {\n%s%s    }\n' % (indent, condition % prefix, tmp_pre, indent)
+            decls += tmp_decl
+            pre_code += tmp_pre
+            post_code += tmp_post
+        return decls, pre_code, post_code
+    #
+    # Generate the unwrapping code for a single NDO or NDO-containing struct member
+    def uniquify_member(self, member, indent, prefix, index, array_index, create_func, destroy_func, destroy_array, first_level_param):
+        decls = ''
+        pre_code = ''
+        post_code = ''
+        process_pnext = self.StructWithExtensions(member.type)
+        # Handle NDOs
+        if self.isHandleTypeNonDispatchable(member.type) == True:
+            count_name = member.len
+            if (count_name is not None):
+                if first_level_param == False:
+                    count_name = '%s%s' % (prefix, member.len)
 
-                if (first_level_param == False) or (create_func == False):
-                    (tmp_decl, tmp_pre, tmp_post) = self.outputNDOs(member.type, member.name, count_name, prefix, index, indent, destroy_func, destroy_array, first_level_param)
-                    decls += tmp_decl
-                    pre_code += tmp_pre
-                    post_code += tmp_post
-            # Handle Structs that contain NDOs at some level
-            elif member.type in self.struct_member_dict:
-                # Structs at first level will have an NDO, OR, we need a safe_struct for the pnext chain
-                if self.struct_contains_ndo(member.type) == True or process_pnext:
-                    struct_info = self.struct_member_dict[member.type]
-                    # Struct Array
-                    if member.len is not None:
-                        # Update struct prefix
-                        if first_level_param == True:
-                            new_prefix = 'local_%s' % member.name
-                            # Declare safe_VarType for struct
-                            decls += '%ssafe_%s *%s = NULL;\n' % (indent, member.type, new_prefix)
-                        else:
-                            new_prefix = '%s%s' % (prefix, member.name)
-                        pre_code += '%s    if (%s%s) {\n' % (indent, prefix, member.name)
-                        indent = self.incIndent(indent)
-                        if first_level_param == True:
-                            pre_code += '%s    %s = new safe_%s[%s];\n' % (indent, new_prefix, member.type, member.len)
-                        pre_code += '%s    for (uint32_t %s = 0; %s < %s%s; ++%s) {\n' % (indent, index, index, prefix, member.len, index)
-                        indent = self.incIndent(indent)
-                        if first_level_param == True:
-                            pre_code += '%s    %s[%s].initialize(&%s[%s]);\n' % (indent, new_prefix, index, member.name, index)
-                            if process_pnext:
-                                pre_code += '%s    %s[%s].pNext = CreateUnwrappedExtensionStructs(dev_data, %s[%s].pNext);\n' % (indent, new_prefix, index, new_prefix, index)
-                        local_prefix = '%s[%s].' % (new_prefix, index)
-                        # Process sub-structs in this struct
-                        (tmp_decl, tmp_pre, tmp_post) = self.uniquify_members(struct_info, indent, local_prefix, array_index, create_func, destroy_func, destroy_array, False)
-                        decls += tmp_decl
-                        pre_code += tmp_pre
-                        post_code += tmp_post
-                        indent = self.decIndent(indent)
-                        pre_code += '%s    }\n' % indent
-                        indent = self.decIndent(indent)
-                        pre_code += '%s    }\n' % indent
-                        if first_level_param == True:
-                            post_code += self.cleanUpLocalDeclarations(indent, prefix, member.name, member.len, index, process_pnext)
-                    # Single Struct
-                    else:
-                        # Update struct prefix
-                        if first_level_param == True:
-                            new_prefix = 'local_%s->' % member.name
-                            decls += '%ssafe_%s *local_%s%s = NULL;\n' % (indent, member.type, prefix, member.name)
-                        else:
-                            new_prefix = '%s%s->' % (prefix, member.name)
-                        # Declare safe_VarType for struct
-                        pre_code += '%s    if (%s%s) {\n' % (indent, prefix, member.name)
-                        indent = self.incIndent(indent)
-                        if first_level_param == True:
-                            pre_code += '%s    local_%s%s = new safe_%s(%s);\n' % (indent, prefix, member.name, member.type, member.name)
-                        # Process sub-structs in this struct
-                        (tmp_decl, tmp_pre, tmp_post) = self.uniquify_members(struct_info, indent, new_prefix, array_index, create_func, destroy_func, destroy_array, False)
-                        decls += tmp_decl
-                        pre_code += tmp_pre
-                        post_code += tmp_post
-                        if process_pnext:
-                            pre_code += '%s    local_%s%s->pNext = CreateUnwrappedExtensionStructs(dev_data, local_%s%s->pNext);\n' % (indent, prefix, member.name, prefix, member.name)
-                        indent = self.decIndent(indent)
-                        pre_code += '%s    }\n' % indent
-                        if first_level_param == True:
-                            post_code += self.cleanUpLocalDeclarations(indent, prefix, member.name, member.len, index, process_pnext)
+            if (first_level_param == False) or (create_func == False):
+                (tmp_decl, tmp_pre, tmp_post) = self.outputNDOs(member.type, member.name, count_name, prefix, index, indent, destroy_func, destroy_array, first_level_param)
+                decls += tmp_decl
+                pre_code += tmp_pre
+                post_code += tmp_post
+        # Handle Structs that contain NDOs at some level
+        elif member.type in self.struct_member_dict:
+            # Structs at first level will have an NDO, OR, we need a copy for the pnext chain
+            if self.struct_contains_ndo(member.type) == True or process_pnext:
+                struct_info = self.struct_member_dict[member.type]
+                # Copy the struct, or struct array, into scratch memory. Below the first level the copy replaces the
+                # original pointer in the enclosing copy.
+                local_name = 'local_%s' % member.name
+                if first_level_param == True:
+                    decls += '%s%s *%s = NULL;\n' % (indent, member.type, local_name)
+                pre_code += '%s    if (%s%s) {\n' % (indent, prefix, member.name)
+                indent = self.incIndent(indent)
+                if member.len is not None:
+                    count_name = member.len if first_level_param == True else '%s%s' % (prefix, member.len)
+                    copy_code = 'scratch.Copy(%s%s, %s)' % (prefix, member.name, count_name)
+                else:
+                    copy_code = 'scratch.Copy(%s%s)' % (prefix, member.name)
+                if first_level_param == True:
+                    pre_code += '%s    %s = %s;\n' % (indent, local_name, copy_code)
+                else:
+                    pre_code += '%s    %s *%s = %s;\n' % (indent, member.type, local_name, copy_code)
+                # Struct Array
+                if member.len is not None:
+                    pre_code += '%s    for (uint32_t %s = 0; %s < %s; ++%s) {\n' % (indent, index, index, count_name, index)
+                    indent = self.incIndent(indent)
+                    new_prefix = '%s[%s].' % (local_name, index)
+                # Single Struct
+                else:
+                    new_prefix = '%s->' % local_name
+                if process_pnext:
+                    pre_code += '%s    %spNext = CreateUnwrappedExtensionStructs(dev_data, scratch, %spNext);\n' % (indent, new_prefix, new_prefix)
+                # Process sub-structs in this struct
+                (tmp_decl, tmp_pre, tmp_post) = self.uniquify_members(struct_info, indent, new_prefix, array_index, create_func, destroy_func, destroy_array, False, member.type)
+                decls += tmp_decl
+                pre_code += tmp_pre
+                post_code += tmp_post
+                if member.len is not None:
+                    indent = self.decIndent(indent)
+                    pre_code += '%s    }\n' % indent
+                if first_level_param == False:
+                    pre_code += '%s    %s%s = %s;\n' % (indent, prefix, member.name, local_name)
+                indent = self.decIndent(indent)
+                pre_code += '%s    }\n' % indent
         return decls, pre_code, post_code
     #
     # For a particular API, generate the non-dispatchable-object wrapping/unwrapping code
@@ -776,7 +808,10 @@ class UniqueObjectsOutputGenerator(OutputGenerator):
                     param_pre_code += destroy_ndo_code
             if param_pre_code:
                 if (not destroy_func) or (destroy_array):
-                    param_pre_code = '%s{\n%s%s%s%s}\n' % ('    ', indent, self.lock_guard(indent), param_pre_code, indent)
+                    param_pre_code = '%s{\n%s%s}\n' % ('    ', param_pre_code, indent)
+            # Unwrapped parameter copies live in scratch memory released when the call returns
+            if 'scratch' in param_pre_code:
+                paramdecl = '%sScratchScope scratch;\n%s' % (indent, paramdecl)
         return paramdecl, param_pre_code, param_post_code
     #
     # Capture command parameter info needed to wrap NDOs as well as handling some boilerplate code
@@ -1532,6 +1532,113 @@ TEST_F(VkLayerTest, InvalidMemoryAliasing) {
     vkFreeMemory(m_device->device(), mem_img, NULL);
 }
 
+TEST_F(VkLayerTest, InvalidMemoryAliasingManyRanges) {
+    TEST_DESCRIPTION(
+        "Bind one long buffer and many short buffers to a single allocation, then bind images next to them and inside the "
+        "long buffer. Only the image inside the long buffer aliases, even though many ranges start between the two.");
+    VkResult err;
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    const uint32_t short_buffer_count = 64;
+    const uint32_t long_buffer_strides = 16;
+
+    VkImageCreateInfo image_create_info = {};
+    image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_create_info.imageType = VK_IMAGE_TYPE_2D;
+    image_create_info.format = VK_FORMAT_R8G8B8A8_UNORM;
+    image_create_info.extent.width = 64;
+    image_create_info.extent.height = 64;
+    image_create_info.extent.depth = 1;
+    image_create_info.mipLevels = 1;
+    image_create_info.arrayLayers = 1;
+    image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    // Image tiling must be optimal to trigger error when aliasing linear buffer
+    image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_create_info.initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED;
+    image_create_info.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkImage separate_image, aliased_image;
+    err = vkCreateImage(m_device->device(), &image_create_info, NULL, &separate_image);
+    ASSERT_VK_SUCCESS(err);
+    err = vkCreateImage(m_device->device(), &image_create_info, NULL, &aliased_image);
+    ASSERT_VK_SUCCESS(err);
+    VkMemoryRequirements img_mem_reqs;
+    vkGetImageMemoryRequirements(m_device->device(), separate_image, &img_mem_reqs);
+    vkGetImageMemoryRequirements(m_device->device(), aliased_image, &img_mem_reqs);
+
+    VkBufferCreateInfo buf_info = {};
+    buf_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buf_info.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    buf_info.size = 256;
+    buf_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer short_buffers[short_buffer_count];
+    VkMemoryRequirements buff_mem_reqs;
+    for (uint32_t i = 0; i < short_buffer_count; i++) {
+        err = vkCreateBuffer(m_device->device(), &buf_info, NULL, &short_buffers[i]);
+        ASSERT_VK_SUCCESS(err);
+        vkGetBufferMemoryRequirements(m_device->device(), short_buffers[i], &buff_mem_reqs);
+    }
+
+    // Every offset used below is a multiple of stride, which satisfies all the alignments and starts a new granularity page.
+    // Alignments and the granularity are powers of two, so a multiple of the largest is a multiple of all of them.
+    VkDeviceSize align = std::max(buff_mem_reqs.alignment, img_mem_reqs.alignment);
+    align = std::max(align, m_device->props.limits.bufferImageGranularity);
+    VkDeviceSize stride = (std::max<VkDeviceSize>(buff_mem_reqs.size, 256) + align - 1) / align * align;
+
+    buf_info.size = long_buffer_strides * stride;
+    VkBuffer long_buffer;
+    err = vkCreateBuffer(m_device->device(), &buf_info, NULL, &long_buffer);
+    ASSERT_VK_SUCCESS(err);
+    VkMemoryRequirements long_buff_mem_reqs;
+    vkGetBufferMemoryRequirements(m_device->device(), long_buffer, &long_buff_mem_reqs);
+
+    VkDeviceSize linear_end = (long_buffer_strides + short_buffer_count) * stride;
+    VkMemoryAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = linear_end + img_mem_reqs.size;
+    bool pass = m_device->phy().set_memory_type(
+        buff_mem_reqs.memoryTypeBits & long_buff_mem_reqs.memoryTypeBits & img_mem_reqs.memoryTypeBits, &alloc_info, 0);
+    if (!pass || long_buff_mem_reqs.size > long_buffer_strides * stride) {
+        for (uint32_t i = 0; i < short_buffer_count; i++) {
+            vkDestroyBuffer(m_device->device(), short_buffers[i], NULL);
+        }
+        vkDestroyBuffer(m_device->device(), long_buffer, NULL);
+        vkDestroyImage(m_device->device(), separate_image, NULL);
+        vkDestroyImage(m_device->device(), aliased_image, NULL);
+        return;
+    }
+    VkDeviceMemory mem;
+    err = vkAllocateMemory(m_device->device(), &alloc_info, NULL, &mem);
+    ASSERT_VK_SUCCESS(err);
+
+    // The long buffer first, then the short buffers one after another, and an image just past the last of them
+    m_errorMonitor->ExpectSuccess(VK_DEBUG_REPORT_ERROR_BIT_EXT | VK_DEBUG_REPORT_WARNING_BIT_EXT);
+    err = vkBindBufferMemory(m_device->device(), long_buffer, mem, 0);
+    ASSERT_VK_SUCCESS(err);
+    for (uint32_t i = 0; i < short_buffer_count; i++) {
+        err = vkBindBufferMemory(m_device->device(), short_buffers[i], mem, (long_buffer_strides + i) * stride);
+        ASSERT_VK_SUCCESS(err);
+    }
+    err = vkBindImageMemory(m_device->device(), separate_image, mem, linear_end);
+    ASSERT_VK_SUCCESS(err);
+    m_errorMonitor->VerifyNotFound();
+
+    // An image in the middle of the long buffer aliases it, although the buffer starts long before the image
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_WARNING_BIT_EXT, " is aliased with linear buffer 0x");
+    vkBindImageMemory(m_device->device(), aliased_image, mem, (long_buffer_strides / 2) * stride);
+    m_errorMonitor->VerifyFound();
+
+    for (uint32_t i = 0; i < short_buffer_count; i++) {
+        vkDestroyBuffer(m_device->device(), short_buffers[i], NULL);
+    }
+    vkDestroyBuffer(m_device->device(), long_buffer, NULL);
+    vkDestroyImage(m_device->device(), separate_image, NULL);
+    vkDestroyImage(m_device->device(), aliased_image, NULL);
+    vkFreeMemory(m_device->device(), mem, NULL);
+}
+
 TEST_F(VkLayerTest, InvalidMemoryMapping) {
     TEST_DESCRIPTION("Attempt to map memory in a number of incorrect ways");
     VkResult err;
@@ -4591,6 +4698,85 @@ TEST_F(VkLayerTest, InvalidCmdBufferBufferDestroyed) {
     vkFreeMemory(m_device->handle(), mem, NULL);
 }
 
+TEST_F(VkLayerTest, InvalidCmdBufferVertexBufferDestroyed) {
+    TEST_DESCRIPTION(
+        "Attempt to submit a command buffer that is invalid "
+        "due to a vertex buffer it drew with being destroyed.");
+    ASSERT_NO_FATAL_FAILURE(Init());
+    ASSERT_NO_FATAL_FAILURE(InitViewport());
+    ASSERT_NO_FATAL_FAILURE(InitRenderTarget());
+
+    VkBuffer buffer;
+    VkDeviceMemory mem;
+    VkMemoryRequirements mem_reqs;
+
+    VkBufferCreateInfo buf_info = {};
+    buf_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buf_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    buf_info.size = 256;
+    buf_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    VkResult err = vkCreateBuffer(m_device->device(), &buf_info, NULL, &buffer);
+    ASSERT_VK_SUCCESS(err);
+
+    vkGetBufferMemoryRequirements(m_device->device(), buffer, &mem_reqs);
+
+    VkMemoryAllocateInfo alloc_info = {};
+    alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    alloc_info.allocationSize = mem_reqs.size;
+    bool pass = m_device->phy().set_memory_type(mem_reqs.memoryTypeBits, &alloc_info, 0);
+    if (!pass) {
+        vkDestroyBuffer(m_device->device(), buffer, NULL);
+        return;
+    }
+    err = vkAllocateMemory(m_device->device(), &alloc_info, NULL, &mem);
+    ASSERT_VK_SUCCESS(err);
+
+    err = vkBindBufferMemory(m_device->device(), buffer, mem, 0);
+    ASSERT_VK_SUCCESS(err);
+
+    VkPipelineLayoutCreateInfo pipeline_layout_ci = {};
+    pipeline_layout_ci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    VkPipelineLayout pipeline_layout;
+    err = vkCreatePipelineLayout(m_device->device(), &pipeline_layout_ci, NULL, &pipeline_layout);
+    ASSERT_VK_SUCCESS(err);
+
+    VkVertexInputBindingDescription input_binding = {0, 4 * sizeof(float), VK_VERTEX_INPUT_RATE_VERTEX};
+    VkShaderObj vs(m_device, bindStateVertShaderText, VK_SHADER_STAGE_VERTEX_BIT, this);
+    VkShaderObj fs(m_device, bindStateFragShaderText, VK_SHADER_STAGE_FRAGMENT_BIT, this);
+    VkPipelineObj pipe(m_device);
+    pipe.AddShader(&vs);
+    pipe.AddShader(&fs);
+    pipe.AddColorAttachment();
+    pipe.AddVertexInputBindings(&input_binding, 1);
+    pipe.SetViewport(m_viewports);
+    pipe.SetScissor(m_scissors);
+    pipe.CreateVKPipeline(pipeline_layout, renderPass());
+
+    m_commandBuffer->begin();
+    m_commandBuffer->BeginRenderPass(m_renderPassBeginInfo);
+    vkCmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipe.handle());
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(m_commandBuffer->handle(), 0, 1, &buffer, &offset);
+    m_commandBuffer->Draw(1, 0, 0, 0);
+    m_commandBuffer->EndRenderPass();
+    m_commandBuffer->end();
+
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, " that is invalid because bound Buffer ");
+    // Destroy the vertex buffer after recording; the submit must not touch its freed state
+    vkDestroyBuffer(m_device->device(), buffer, NULL);
+
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &m_commandBuffer->handle();
+    vkQueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+
+    m_errorMonitor->VerifyFound();
+    vkQueueWaitIdle(m_device->m_queue);
+    vkDestroyPipelineLayout(m_device->device(), pipeline_layout, NULL);
+    vkFreeMemory(m_device->handle(), mem, NULL);
+}
+
 TEST_F(VkLayerTest, InvalidCmdBufferBufferViewDestroyed) {
     TEST_DESCRIPTION("Delete bufferView bound to cmd buffer, then attempt to submit cmd buffer.");
 
@@ -12710,6 +12896,65 @@ TEST_F(VkLayerTest, InvalidImageLayout) {
     vkDestroyImage(m_device->device(), depth_image, NULL);
 }
 
+TEST_F(VkLayerTest, InvalidImageLayoutAcrossCommandBuffers) {
+    TEST_DESCRIPTION(
+        "Submit two command buffers at once. The first transitions only mip level 0 of an image, and the second assumes "
+        "mip levels 0 and 1 are both in the new layout. Only mip level 1 should be reported.");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    VkImageObj image(m_device);
+    image.InitNoLayout(128, 128, 4, VK_FORMAT_B8G8R8A8_UNORM, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                       VK_IMAGE_TILING_OPTIMAL, 0);
+    ASSERT_TRUE(image.initialized());
+
+    auto transition = [&image](VkCommandBuffer command_buffer, uint32_t base_mip, uint32_t mip_count, VkImageLayout old_layout,
+                               VkImageLayout new_layout) {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) ? VK_ACCESS_TRANSFER_WRITE_BIT : 0;
+        barrier.dstAccessMask = (new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) ? VK_ACCESS_TRANSFER_WRITE_BIT : 0;
+        barrier.oldLayout = old_layout;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.handle();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, base_mip, mip_count, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                             nullptr, 1, &barrier);
+    };
+
+    VkCommandBufferObj setup(m_device, m_commandPool);
+    setup.begin();
+    transition(setup.handle(), 0, 4, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    setup.end();
+    setup.QueueCommandBuffer();
+
+    VkCommandBufferObj first(m_device, m_commandPool);
+    first.begin();
+    transition(first.handle(), 0, 1, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    first.end();
+
+    VkCommandBufferObj second(m_device, m_commandPool);
+    second.begin();
+    transition(second.handle(), 0, 2, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    second.end();
+
+    VkCommandBuffer command_buffers[] = {first.handle(), second.handle()};
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 2;
+    submit_info.pCommandBuffers = command_buffers;
+
+    m_errorMonitor->SetDesiredFailureMsg(
+        VK_DEBUG_REPORT_ERROR_BIT_EXT,
+        "mip level 1], with layout VK_IMAGE_LAYOUT_GENERAL when first use is VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL");
+    vkQueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    m_errorMonitor->VerifyFound();
+
+    vkQueueWaitIdle(m_device->m_queue);
+}
+
 TEST_F(VkLayerTest, InvalidStorageImageLayout) {
     TEST_DESCRIPTION("Attempt to update a STORAGE_IMAGE descriptor w/o GENERAL layout.");
     VkResult err;
@@ -14064,6 +14309,309 @@ TEST_F(VkLayerTest, ThreadCommandBufferCollision) {
 
     vkDestroyEvent(device(), event, NULL);
 }
+
+struct recording_thread_data {
+    VkCommandBuffer command_buffer;
+    VkBuffer buffer;
+    VkEvent event;
+};
+
+extern "C" void *RecordIntoCommandBuffer(void *arg) {
+    struct recording_thread_data *data = (struct recording_thread_data *)arg;
+
+    for (uint32_t i = 0; i < 10000; i++) {
+        vkCmdFillBuffer(data->command_buffer, data->buffer, 0, 4, i);
+        vkCmdSetEvent(data->command_buffer, data->event, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    }
+    return NULL;
+}
+
+TEST_F(VkPositiveLayerTest, ThreadedCommandBufferRecording) {
+    TEST_DESCRIPTION(
+        "Record into several command buffers, each from its own pool, on several threads at once. All of them use the same "
+        "buffer, so its command buffer bindings are updated concurrently.");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    const uint32_t thread_count = 4;
+    VkMemoryPropertyFlags reqs = 0;
+    vk_testing::Buffer buffer;
+    buffer.init_as_dst(*m_device, (VkDeviceSize)256, reqs);
+
+    VkCommandPoolCreateInfo pool_create_info = {};
+    pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_create_info.queueFamilyIndex = m_device->graphics_queue_node_index_;
+
+    VkEventCreateInfo event_create_info = {};
+    event_create_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    m_errorMonitor->ExpectSuccess();
+
+    VkCommandPool pools[thread_count];
+    VkCommandBuffer command_buffers[thread_count];
+    struct recording_thread_data data[thread_count];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ASSERT_VK_SUCCESS(vkCreateCommandPool(m_device->device(), &pool_create_info, NULL, &pools[i]));
+        VkCommandBufferAllocateInfo allocate_info = {};
+        allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocate_info.commandPool = pools[i];
+        allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocate_info.commandBufferCount = 1;
+        ASSERT_VK_SUCCESS(vkAllocateCommandBuffers(m_device->device(), &allocate_info, &command_buffers[i]));
+        ASSERT_VK_SUCCESS(vkBeginCommandBuffer(command_buffers[i], &begin_info));
+
+        data[i].command_buffer = command_buffers[i];
+        data[i].buffer = buffer.handle();
+        ASSERT_VK_SUCCESS(vkCreateEvent(m_device->device(), &event_create_info, NULL, &data[i].event));
+    }
+
+    test_platform_thread threads[thread_count];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        test_platform_thread_create(&threads[i], RecordIntoCommandBuffer, (void *)&data[i]);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        test_platform_thread_join(threads[i], NULL);
+    }
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ASSERT_VK_SUCCESS(vkEndCommandBuffer(command_buffers[i]));
+    }
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = thread_count;
+    submit_info.pCommandBuffers = command_buffers;
+    ASSERT_VK_SUCCESS(vkQueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE));
+    ASSERT_VK_SUCCESS(vkQueueWaitIdle(m_device->m_queue));
+
+    m_errorMonitor->VerifyNotFound();
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        vkDestroyEvent(m_device->device(), data[i].event, NULL);
+        vkDestroyCommandPool(m_device->device(), pools[i], NULL);
+    }
+}
+
+TEST_F(VkLayerTest, ThreadCommandPoolCollision) {
+    TEST_DESCRIPTION(
+        "Record into two different command buffers allocated from the same pool on two threads at once. The pool is "
+        "externally synchronized, so the threading layer reports the collision on the pool.");
+
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "THREADING ERROR");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    VkCommandBufferObj command_buffer_a(m_device, m_commandPool);
+    VkCommandBufferObj command_buffer_b(m_device, m_commandPool);
+    command_buffer_a.begin();
+    command_buffer_b.begin();
+
+    VkEventCreateInfo event_info = {};
+    event_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+    VkEvent event;
+    ASSERT_VK_SUCCESS(vkCreateEvent(device(), &event_info, NULL, &event));
+
+    struct thread_data_struct data_a;
+    data_a.commandBuffer = command_buffer_a.handle();
+    data_a.event = event;
+    data_a.bailout = false;
+    struct thread_data_struct data_b = data_a;
+    data_b.commandBuffer = command_buffer_b.handle();
+    m_errorMonitor->SetBailout(&data_a.bailout);
+
+    test_platform_thread thread;
+    test_platform_thread_create(&thread, AddToCommandBuffer, (void *)&data_a);
+    // Stop this thread as soon as the other one has seen the error.
+    for (int i = 0; i < 80000 && !data_a.bailout; i++) {
+        vkCmdSetEvent(data_b.commandBuffer, data_b.event, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+    }
+    test_platform_thread_join(thread, NULL);
+    command_buffer_a.end();
+    command_buffer_b.end();
+
+    m_errorMonitor->SetBailout(NULL);
+
+    m_errorMonitor->VerifyFound();
+
+    vkDestroyEvent(device(), event, NULL);
+}
+
+struct pool_churn_thread_data {
+    VkDevice device;
+    uint32_t queue_family_index;
+    VkEvent event;
+    VkResult result;
+};
+
+extern "C" void *ChurnCommandPool(void *arg) {
+    struct pool_churn_thread_data *data = (struct pool_churn_thread_data *)arg;
+
+    VkCommandPoolCreateInfo pool_create_info = {};
+    pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_create_info.queueFamilyIndex = data->queue_family_index;
+    VkCommandPool pool;
+    data->result = vkCreateCommandPool(data->device, &pool_create_info, NULL, &pool);
+    if (data->result != VK_SUCCESS) {
+        return NULL;
+    }
+
+    VkCommandBufferAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocate_info.commandPool = pool;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = 8;
+
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    // Every allocation and free adds and removes entries in the threading layer's command-buffer-to-pool table while
+    // the other threads do the same, and every recorded command goes through the pool's use counter.
+    for (uint32_t i = 0; i < 500 && data->result == VK_SUCCESS; i++) {
+        VkCommandBuffer command_buffers[8];
+        data->result = vkAllocateCommandBuffers(data->device, &allocate_info, command_buffers);
+        if (data->result != VK_SUCCESS) {
+            break;
+        }
+        for (uint32_t j = 0; j < allocate_info.commandBufferCount && data->result == VK_SUCCESS; j++) {
+            data->result = vkBeginCommandBuffer(command_buffers[j], &begin_info);
+            if (data->result == VK_SUCCESS) {
+                vkCmdSetEvent(command_buffers[j], data->event, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+                data->result = vkEndCommandBuffer(command_buffers[j]);
+            }
+        }
+        vkFreeCommandBuffers(data->device, pool, allocate_info.commandBufferCount, command_buffers);
+    }
+
+    vkDestroyCommandPool(data->device, pool, NULL);
+    return NULL;
+}
+
+TEST_F(VkPositiveLayerTest, ThreadedCommandPoolChurn) {
+    TEST_DESCRIPTION(
+        "Create a command pool on each of several threads and repeatedly allocate, record and free command buffers from it "
+        "while the other threads do the same. No two threads share a pool, so the threading layer must not report a "
+        "collision.");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    const uint32_t thread_count = 8;
+
+    VkEventCreateInfo event_create_info = {};
+    event_create_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+    m_errorMonitor->ExpectSuccess();
+
+    struct pool_churn_thread_data data[thread_count];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        data[i].device = m_device->device();
+        data[i].queue_family_index = m_device->graphics_queue_node_index_;
+        data[i].result = VK_SUCCESS;
+        ASSERT_VK_SUCCESS(vkCreateEvent(m_device->device(), &event_create_info, NULL, &data[i].event));
+    }
+
+    test_platform_thread threads[thread_count];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        test_platform_thread_create(&threads[i], ChurnCommandPool, (void *)&data[i]);
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        test_platform_thread_join(threads[i], NULL);
+    }
+
+    m_errorMonitor->VerifyNotFound();
+
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ASSERT_VK_SUCCESS(data[i].result);
+        vkDestroyEvent(m_device->device(), data[i].event, NULL);
+    }
+}
+struct device_churn_thread_data {
+    VkPhysicalDevice gpu;
+    const VkDeviceCreateInfo *create_info;
+    VkResult result;
+};
+
+extern "C" void *ChurnDevice(void *arg) {
+    struct device_churn_thread_data *data = (struct device_churn_thread_data *)arg;
+
+    VkEventCreateInfo event_create_info = {};
+    event_create_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+    for (uint32_t i = 0; i < 20; i++) {
+        VkDevice device;
+        data->result = vkCreateDevice(data->gpu, data->create_info, NULL, &device);
+        if (data->result != VK_SUCCESS) {
+            break;
+        }
+        // Look the new device up in each layer's data map a few times before it goes away again
+        for (uint32_t j = 0; j < 16 && data->result == VK_SUCCESS; j++) {
+            VkEvent event;
+            data->result = vkCreateEvent(device, &event_create_info, NULL, &event);
+            if (data->result == VK_SUCCESS) {
+                vkDestroyEvent(device, event, NULL);
+            }
+        }
+        vkDestroyDevice(device, NULL);
+    }
+    return NULL;
+}
+
+TEST_F(VkPositiveLayerTest, ThreadedDeviceCreateDestroy) {
+    TEST_DESCRIPTION(
+        "Create and destroy devices on several threads at once while the test's own device stays in use. More devices are "
+        "live than the layers' per-key data maps hold inline, so entries move between the inline slots and the overflow "
+        "table while other threads look them up.");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    const uint32_t thread_count = 8;
+
+    float priorities[] = {1.0f};
+    VkDeviceQueueCreateInfo queue_info = {};
+    queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queue_info.queueFamilyIndex = m_device->graphics_queue_node_index_;
+    queue_info.queueCount = 1;
+    queue_info.pQueuePriorities = &priorities[0];
+
+    VkDeviceCreateInfo device_create_info = {};
+    device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_create_info.queueCreateInfoCount = 1;
+    device_create_info.pQueueCreateInfos = &queue_info;
+
+    VkEventCreateInfo event_create_info = {};
+    event_create_info.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+
+    m_errorMonitor->ExpectSuccess();
+
+    struct device_churn_thread_data data[thread_count];
+    test_platform_thread threads[thread_count];
+    for (uint32_t i = 0; i < thread_count; i++) {
+        data[i].gpu = gpu();
+        data[i].create_info = &device_create_info;
+        data[i].result = VK_SUCCESS;
+        test_platform_thread_create(&threads[i], ChurnDevice, (void *)&data[i]);
+    }
+    // Keep the existing device busy so its entry is looked up while the others come and go
+    VkResult result = VK_SUCCESS;
+    for (uint32_t i = 0; i < 2000 && result == VK_SUCCESS; i++) {
+        VkEvent event;
+        result = vkCreateEvent(m_device->device(), &event_create_info, NULL, &event);
+        if (result == VK_SUCCESS) {
+            vkDestroyEvent(m_device->device(), event, NULL);
+        }
+    }
+    for (uint32_t i = 0; i < thread_count; i++) {
+        test_platform_thread_join(threads[i], NULL);
+    }
+
+    m_errorMonitor->VerifyNotFound();
+
+    ASSERT_VK_SUCCESS(result);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ASSERT_VK_SUCCESS(data[i].result);
+    }
+}
 #endif  // GTEST_IS_THREADSAFE
 
 TEST_F(VkLayerTest, InvalidSPIRVCodeSize) {
@@ -19200,6 +19748,22 @@ TEST_F(VkLayerTest, ExtensionNotEnabled) {
 // POSITIVE VALIDATION TESTS
 //
 // These tests do not expect to encounter ANY validation errors pass only if this is true
+TEST_F(VkPositiveLayerTest, FormatTableMatchesReference) {
+    TEST_DESCRIPTION(
+        "Check that the per-format table behind the format queries in vk_format_utils gives the same answers as the "
+        "classification switches it is built from, for every core format, every extension format and a few values that "
+        "are not formats at all.");
+
+    for (uint32_t format = VK_FORMAT_BEGIN_RANGE; format <= VK_FORMAT_END_RANGE + 1; ++format) {
+        EXPECT_TRUE(FormatTableMatchesReference(static_cast<VkFormat>(format))) << "format " << format;
+    }
+    for (uint32_t format = VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG - 1; format <= VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG + 1;
+         ++format) {
+        EXPECT_TRUE(FormatTableMatchesReference(static_cast<VkFormat>(format))) << "format " << format;
+    }
+    EXPECT_TRUE(FormatTableMatchesReference(VK_FORMAT_MAX_ENUM));
+}
+
 TEST_F(VkPositiveLayerTest, DeleteDescriptorSetLayoutsBeforeDescriptorSets) {
     TEST_DESCRIPTION("Create DSLayouts and DescriptorSets and then delete the DSLayouts before the DescriptorSets.");
     ASSERT_NO_FATAL_FAILURE(Init());
@@ -20349,6 +20913,86 @@ TEST_F(VkPositiveLayerTest, QueueSubmitSemaphoresAndLayoutTracking) {
     m_errorMonitor->VerifyNotFound();
 }
 
+TEST_F(VkPositiveLayerTest, ImageLayoutTrackingAcrossCommandBuffers) {
+    TEST_DESCRIPTION(
+        "Transition different mip levels of one image in several command buffers of the same submission, so later command "
+        "buffers see layouts set by earlier ones for some mip levels and the image's last submitted layouts for others. A "
+        "later submission then expects the final layouts.");
+
+    m_errorMonitor->ExpectSuccess();
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    VkImageObj image(m_device);
+    image.InitNoLayout(128, 128, 4, VK_FORMAT_B8G8R8A8_UNORM, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                       VK_IMAGE_TILING_OPTIMAL, 0);
+    ASSERT_TRUE(image.initialized());
+
+    auto access_for_layout = [](VkImageLayout layout) -> VkAccessFlags {
+        if (layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) return VK_ACCESS_TRANSFER_WRITE_BIT;
+        if (layout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) return VK_ACCESS_TRANSFER_READ_BIT;
+        return 0;
+    };
+    auto transition = [&image, &access_for_layout](VkCommandBuffer command_buffer, uint32_t base_mip, uint32_t mip_count,
+                                                   VkImageLayout old_layout, VkImageLayout new_layout) {
+        VkImageMemoryBarrier barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = access_for_layout(old_layout);
+        barrier.dstAccessMask = access_for_layout(new_layout);
+        barrier.oldLayout = old_layout;
+        barrier.newLayout = new_layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image.handle();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, base_mip, mip_count, 0, 1};
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                             nullptr, 1, &barrier);
+    };
+
+    VkCommandBufferObj setup(m_device, m_commandPool);
+    setup.begin();
+    transition(setup.handle(), 0, 4, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    setup.end();
+    setup.QueueCommandBuffer();
+
+    // Mip levels 0-1 go to TRANSFER_DST
+    VkCommandBufferObj first(m_device, m_commandPool);
+    first.begin();
+    transition(first.handle(), 0, 2, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    first.end();
+
+    // Mip level 0 continues from the first command buffer, mip levels 2-3 from the setup submission
+    VkCommandBufferObj second(m_device, m_commandPool);
+    second.begin();
+    transition(second.handle(), 0, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    transition(second.handle(), 2, 2, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    second.end();
+
+    // Mip levels 1-3 are TRANSFER_DST, set by different command buffers
+    VkCommandBufferObj third(m_device, m_commandPool);
+    third.begin();
+    transition(third.handle(), 0, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    transition(third.handle(), 1, 3, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
+    third.end();
+
+    VkCommandBuffer command_buffers[] = {first.handle(), second.handle(), third.handle()};
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 3;
+    submit_info.pCommandBuffers = command_buffers;
+    ASSERT_VK_SUCCESS(vkQueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE));
+    ASSERT_VK_SUCCESS(vkQueueWaitIdle(m_device->m_queue));
+
+    // Every mip level is back in GENERAL once the submission above has been recorded
+    VkCommandBufferObj last(m_device, m_commandPool);
+    last.begin();
+    transition(last.handle(), 0, 4, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    last.end();
+    last.QueueCommandBuffer();
+
+    m_errorMonitor->VerifyNotFound();
+}
+
 TEST_F(VkPositiveLayerTest, DynamicOffsetWithInactiveBinding) {
     // Create a descriptorSet w/ dynamic descriptors where 1 binding is inactive
     // We previously had a bug where dynamic offset of inactive bindings was still being used